@@ -0,0 +1,83 @@
+//
+// Created by tor on 10/19/26.
+//
+
+#include <algorithm>
+#include <chrono>
+#include <cmath>
+#include <iostream>
+#include "Benchmark.h"
+#include "animation/AnimatedModelLoader.h"
+
+static const char *get_mode_name(SamplingMode mode) {
+  switch (mode) {
+	case SamplingMode::KEYFRAMES: return "keyframes";
+	case SamplingMode::BAKED_NEAREST: return "baked (nearest)";
+	case SamplingMode::BAKED_INTERPOLATED: return "baked (interpolated)";
+  }
+  return "unknown";
+}
+
+// Compares evaluating a palette from the keyframes against sampling pre-baked palettes, and reports the memory
+// that the baked palettes cost.
+int run_baked_palettes_benchmark(const std::vector<std::string> &args) {
+  const int evaluation_count = get_int_option(args, "--evaluations", 100000);
+  const int frame_rate = get_int_option(args, "--frame-rate", 60);
+
+  GLFWwindow *window = create_offscreen_context();
+  if (window == nullptr) {
+	return 1;
+  }
+
+  for (const auto *animation_path : {"../assets/run.fbx", "../assets/jump.fbx"}) {
+	auto model = AnimatedModelLoader::load_model("../assets/character.fbx", animation_path);
+	if (!model) {
+	  std::cerr << "Could not load " << animation_path << "\n";
+	  destroy_offscreen_context(window);
+	  return 1;
+	}
+
+	std::vector<glm::mat4> reference = model->skinning_matrices;
+	std::vector<glm::mat4> skinning_matrices = model->skinning_matrices;
+	std::cout << animation_path << ":\n";
+	for (auto mode : {SamplingMode::KEYFRAMES, SamplingMode::BAKED_NEAREST, SamplingMode::BAKED_INTERPOLATED}) {
+	  if (mode == SamplingMode::KEYFRAMES) {
+		model->sampling_mode = mode;
+	  } else {
+		model->bake_palettes(frame_rate, mode);
+	  }
+
+	  // Samples the clip at times that do not line up with the baked frames
+	  float max_error = 0.0f;
+	  auto start = std::chrono::steady_clock::now();
+	  for (int i = 0; i < evaluation_count; i++) {
+		double time = std::fmod(i * 0.37, model->animation_duration);
+		model->evaluate_pose(time, skinning_matrices);
+		if (i % 1000 == 0) {
+		  auto sampling_mode = model->sampling_mode;
+		  model->sampling_mode = SamplingMode::KEYFRAMES;
+		  model->evaluate_pose(time, reference);
+		  model->sampling_mode = sampling_mode;
+		  for (int bone = 0; bone < model->get_bone_count(); bone++) {
+			for (int column = 0; column < 4; column++) {
+			  auto error = glm::abs(reference[bone][column] - skinning_matrices[bone][column]);
+			  max_error = std::max({max_error, error.x, error.y, error.z, error.w});
+			}
+		  }
+		}
+	  }
+	  std::chrono::duration<double, std::micro> elapsed = std::chrono::steady_clock::now() - start;
+
+	  std::cout << "  " << get_mode_name(mode) << ": " << elapsed.count() / evaluation_count << " us per palette, max error "
+				<< max_error;
+	  if (model->baked_palettes && mode != SamplingMode::KEYFRAMES) {
+		std::cout << ", " << model->baked_palettes->frame_count << " frames using "
+				  << model->baked_palettes->get_memory_usage() / 1024 << " KB";
+	  }
+	  std::cout << "\n";
+	}
+  }
+
+  destroy_offscreen_context(window);
+  return 0;
+}
@@ -0,0 +1,59 @@
+//
+// Created by tor on 10/19/26.
+//
+
+#include <algorithm>
+#include <iostream>
+#include "Benchmark.h"
+
+GLFWwindow *create_offscreen_context() {
+  glfwInit();
+  glfwWindowHint(GLFW_CONTEXT_VERSION_MAJOR, 4);
+  glfwWindowHint(GLFW_CONTEXT_VERSION_MINOR, 5);
+  glfwWindowHint(GLFW_OPENGL_PROFILE, GLFW_OPENGL_CORE_PROFILE);
+  glfwWindowHint(GLFW_VISIBLE, GLFW_FALSE);
+
+  GLFWwindow *window = glfwCreateWindow(64, 64, "Benchmark", nullptr, nullptr);
+  if (window == nullptr) {
+	std::cerr << "Failed to create an offscreen OpenGL context" << std::endl;
+	glfwTerminate();
+	return nullptr;
+  }
+  glfwMakeContextCurrent(window);
+
+  if (!gladLoadGLLoader((GLADloadproc)glfwGetProcAddress)) {
+	std::cerr << "Failed to initialize GLAD" << std::endl;
+	destroy_offscreen_context(window);
+	return nullptr;
+  }
+
+  std::cout << "OpenGL renderer: " << glGetString(GL_RENDERER) << "\n";
+  return window;
+}
+
+void destroy_offscreen_context(GLFWwindow *window) {
+  glfwDestroyWindow(window);
+  glfwTerminate();
+}
+
+int get_int_option(const std::vector<std::string> &args, const std::string &name, int default_value) {
+  auto option = std::find(args.begin(), args.end(), name);
+  if (option == args.end() || option + 1 == args.end()) {
+	return default_value;
+  }
+  return std::stoi(*(option + 1));
+}
+
+glm::dvec3 skin_vertex_reference(const AnimatedVertex &vertex,
+								 const glm::mat4 *palette,
+								 const glm::mat4 &model_matrix) {
+  const glm::dvec4 position{vertex.pos, 1.0};
+  glm::dvec4 total_position{0.0};
+  for (int i = 0; i < MAX_BONE_PER_VERTEX; i++) {
+	if (vertex.bone_ids[i] == -1) {
+	  continue;
+	}
+	total_position += glm::dmat4(palette[vertex.bone_ids[i]]) * position * (double)vertex.bone_weights[i];
+  }
+  return glm::dvec3(glm::dmat4(model_matrix) * total_position);
+}
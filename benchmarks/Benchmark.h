@@ -0,0 +1,46 @@
+//
+// Created by tor on 10/19/26.
+//
+
+#ifndef OPENGL_SKELETAL_ANIMATION_BENCHMARKS_BENCHMARK_H_
+#define OPENGL_SKELETAL_ANIMATION_BENCHMARKS_BENCHMARK_H_
+
+#include <glad/glad.h>
+#include <GLFW/glfw3.h>
+#include <string>
+#include <vector>
+#include <glm/glm.hpp>
+#include "animation/Model.h"
+
+// The largest difference (in world units) that is accepted between a skinning path & the reference
+static const double MAX_SKINNING_ERROR = 1e-4;
+
+// Creates a hidden window with an OpenGL 4.5 core context. Setting LIBGL_ALWAYS_SOFTWARE=1 selects Mesa's software
+// renderer (e.g. under xvfb-run).
+[[nodiscard]] GLFWwindow *create_offscreen_context();
+void destroy_offscreen_context(GLFWwindow *window);
+
+// Returns the value following name in args (e.g. "--instances 5000"), or default_value if it is not given
+[[nodiscard]] int get_int_option(const std::vector<std::string> &args, const std::string &name, int default_value);
+
+// Skins a vertex the same way as skeletal_animation_instanced.vert.glsl, but in double precision. This is the
+// reference that the other skinning paths are compared against. The palette is the local palette of the vertex's
+// mesh.
+[[nodiscard]] glm::dvec3 skin_vertex_reference(const AnimatedVertex &vertex,
+											   const glm::mat4 *palette,
+											   const glm::mat4 &model_matrix);
+
+// Every benchmark takes the command line arguments that follow its name and returns the process exit code
+int run_clip_grouping_benchmark(const std::vector<std::string> &args);
+int run_pose_cache_benchmark(const std::vector<std::string> &args);
+int run_baked_palettes_benchmark(const std::vector<std::string> &args);
+int run_ring_buffer_benchmark(const std::vector<std::string> &args);
+int run_compute_skinning_benchmark(const std::vector<std::string> &args);
+int run_cpu_skinning_benchmark(const std::vector<std::string> &args);
+int run_vertex_format_benchmark(const std::vector<std::string> &args);
+int run_mesh_optimizer_benchmark(const std::vector<std::string> &args);
+int run_dual_quaternion_benchmark(const std::vector<std::string> &args);
+int run_palette_delta_benchmark(const std::vector<std::string> &args);
+int run_static_pose_benchmark(const std::vector<std::string> &args);
+
+#endif //OPENGL_SKELETAL_ANIMATION_BENCHMARKS_BENCHMARK_H_
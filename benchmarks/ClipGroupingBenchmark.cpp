@@ -0,0 +1,85 @@
+//
+// Created by tor on 10/19/26.
+//
+
+#include <chrono>
+#include <iomanip>
+#include <iostream>
+#include <limits>
+#include <random>
+#include <glm/gtc/matrix_transform.hpp>
+#include "Benchmark.h"
+#include "PerfCounters.h"
+#include "animation/AnimatedModelLoader.h"
+#include "animation/AnimationScheduler.h"
+
+// Compares updating a crowd in arbitrary order against updating it grouped by clip, both in time and in
+// cache misses as reported by the CPU's performance counters.
+int run_clip_grouping_benchmark(const std::vector<std::string> &args) {
+  const int instance_count = get_int_option(args, "--instances", 5000);
+  const int tick_count = get_int_option(args, "--ticks", 100);
+  const double tick_length = 1.0 / 30.0;
+
+  GLFWwindow *window = create_offscreen_context();
+  if (window == nullptr) {
+	return 1;
+  }
+
+  // The same character with two different clips, each model is one (skeleton, clip) pair
+  std::vector<Model> models;
+  models.reserve(2);
+  for (const auto *animation_path : {"../assets/run.fbx", "../assets/jump.fbx"}) {
+	auto model = AnimatedModelLoader::load_model("../assets/character.fbx", animation_path);
+	if (!model) {
+	  std::cerr << "Could not load " << animation_path << "\n";
+	  destroy_offscreen_context(window);
+	  return 1;
+	}
+	models.push_back(*model);
+  }
+
+  // Instances are scattered randomly so that the scheduler's priority order interleaves the clips
+  std::mt19937 random(42);
+  std::uniform_real_distribution<float> position(-50.0f, 50.0f);
+  std::uniform_real_distribution<double> phase(0.0, 1.0);
+  std::vector<AnimationInstance> instances;
+  instances.reserve(instance_count);
+  for (int i = 0; i < instance_count; i++) {
+	auto &model = models[random() % models.size()];
+	glm::mat4 model_matrix = glm::translate(glm::mat4(1.0f), glm::vec3(position(random), 0.0f, position(random)));
+	auto &instance = instances.emplace_back(&model, glm::scale(model_matrix, glm::vec3(0.01f)));
+	instance.animation_time = phase(random) * model.animation_duration;
+  }
+
+  std::cout << instance_count << " instances, " << models.size() << " clips, " << tick_count << " ticks\n";
+  PerfCounters counters;
+  if (!counters.is_available()) {
+	std::cout << "Hardware performance counters are not available, only reporting time\n";
+  }
+
+  for (bool group_by_clip : {false, true}) {
+	auto run_instances = instances;
+	// The budget is unlimited so that both runs update exactly the same instances
+	AnimationScheduler scheduler{std::numeric_limits<double>::max()};
+	scheduler.set_group_by_clip(group_by_clip);
+	scheduler.update(run_instances, tick_length, {0.0f, 2.0f, 0.0f});
+
+	counters.start();
+	auto start = std::chrono::steady_clock::now();
+	for (int tick = 0; tick < tick_count; tick++) {
+	  scheduler.update(run_instances, tick_length, {0.0f, 2.0f, 0.0f});
+	}
+	std::chrono::duration<double, std::milli> elapsed = std::chrono::steady_clock::now() - start;
+	counters.stop();
+
+	std::cout << (group_by_clip ? "Grouped by clip:" : "Arbitrary order:") << "\n";
+	std::cout << "  " << std::setw(24) << std::left << "ms per tick" << elapsed.count() / tick_count << "\n";
+	for (const auto &[name, value] : counters.get_results()) {
+	  std::cout << "  " << std::setw(24) << std::left << name + " per instance"
+				<< (double)value / ((double)tick_count * instance_count) << "\n";
+	}
+  }
+
+  destroy_offscreen_context(window);
+  return 0;
+}
@@ -0,0 +1,224 @@
+//
+// Created by tor on 10/19/26.
+//
+
+#include <algorithm>
+#include <chrono>
+#include <fstream>
+#include <iostream>
+#include <map>
+#include <numeric>
+#include <glm/gtc/matrix_transform.hpp>
+#include "Benchmark.h"
+#include "animation/AnimatedModelLoader.h"
+#include "renderer/ComputeSkinner.h"
+#include "renderer/MeshArena.h"
+#include "renderer/Renderer.h"
+
+// Links the vertex shader on its own and captures gl_Position with transform feedback, so that the vertex shader
+// skinning path can be read back without rasterizing anything
+static unsigned int create_capture_program(const std::string &vertex_path, const std::vector<std::string> &defines) {
+  std::ifstream vertex_stream(vertex_path);
+  std::string vertex_code((std::istreambuf_iterator<char>(vertex_stream)), (std::istreambuf_iterator<char>()));
+  vertex_code = Shader::injectDefines(vertex_code, defines);
+  const char *source = vertex_code.c_str();
+
+  unsigned int vertex_shader = glCreateShader(GL_VERTEX_SHADER);
+  glShaderSource(vertex_shader, 1, &source, nullptr);
+  glCompileShader(vertex_shader);
+
+  unsigned int program = glCreateProgram();
+  glAttachShader(program, vertex_shader);
+  const char *varyings[] = {"gl_Position"};
+  glTransformFeedbackVaryings(program, 1, varyings, GL_INTERLEAVED_ATTRIBS);
+  glLinkProgram(program);
+  glDeleteShader(vertex_shader);
+
+  GLint linked = 0;
+  glGetProgramiv(program, GL_LINK_STATUS, &linked);
+  if (!linked) {
+	char info_log[1024];
+	glGetProgramInfoLog(program, sizeof(info_log), nullptr, info_log);
+	std::cerr << "Could not link " << vertex_path << ":\n" << info_log << "\n";
+	glDeleteProgram(program);
+	return 0;
+  }
+
+  // The positions are compared in world space
+  const glm::mat4 identity{1.0f};
+  glProgramUniformMatrix4fv(program, glGetUniformLocation(program, "projection"), 1, GL_FALSE, &identity[0][0]);
+  glProgramUniformMatrix4fv(program, glGetUniformLocation(program, "view"), 1, GL_FALSE, &identity[0][0]);
+  return program;
+}
+
+// Validates compute shader skinning against a CPU reference and against the vertex shader path (read back with
+// transform feedback), then measures how many vertices per second the compute pass skins. Exits with a non-zero
+// status if any path differs by more than MAX_SKINNING_ERROR. Works with Mesa's software renderer
+// (LIBGL_ALWAYS_SOFTWARE=1).
+int run_compute_skinning_benchmark(const std::vector<std::string> &args) {
+  const int instance_count = get_int_option(args, "--instances", 64);
+  const int frame_count = get_int_option(args, "--frames", 100);
+
+  GLFWwindow *window = create_offscreen_context();
+  if (window == nullptr) {
+	return 1;
+  }
+
+  bool valid = true;
+  {
+	auto model_opt = AnimatedModelLoader::load_model("../assets/character.fbx", "../assets/run.fbx");
+	if (!model_opt) {
+	  std::cerr << "Could not load the character model\n";
+	  destroy_offscreen_context(window);
+	  return 1;
+	}
+	auto model = *model_opt;
+	MeshArena mesh_arena{};
+	mesh_arena.add_model(model);
+
+	std::vector<AnimationInstance> instances;
+	instances.reserve(instance_count);
+	for (int i = 0; i < instance_count; i++) {
+	  glm::vec3 position{(float)(i % 8) * 2.0f, 0.0f, (float)(i / 8) * 2.0f};
+	  glm::mat4 model_matrix = glm::translate(glm::mat4(1.0f), position);
+	  model_matrix = glm::scale(model_matrix, glm::vec3(0.01f));
+	  instances.emplace_back(&model, model_matrix).update(0.37 * i);
+	}
+
+	size_t vertices_per_instance = 0;
+	std::vector<size_t> mesh_vertex_offsets;
+	for (const auto &mesh : model.mesh_list) {
+	  mesh_vertex_offsets.push_back(vertices_per_instance);
+	  vertices_per_instance += mesh.vertices.size();
+	}
+	RingBuffer ring_buffer{Renderer::get_frame_data_size(model, instance_count)};
+	ComputeSkinner compute_skinner{mesh_arena, "../shaders/skinning.comp.glsl"};
+
+	// The reference is laid out like the compute skinner's output: by instance, then by mesh
+	std::vector<glm::dvec3> reference;
+	reference.reserve(instance_count * vertices_per_instance);
+	std::vector<glm::mat4> palette(model.get_palette_size());
+	for (const auto &instance : instances) {
+	  instance.write_render_skinning_matrices(palette.data());
+	  for (const auto &mesh : model.mesh_list) {
+		const glm::mat4 *mesh_palette = palette.data() + mesh.palette_offset;
+		for (const auto &vertex : mesh.vertices) {
+		  reference.push_back(skin_vertex_reference(vertex, mesh_palette, instance.model_matrix));
+		}
+	  }
+	}
+
+	ring_buffer.begin_frame();
+	compute_skinner.skin(instances, ring_buffer);
+	ring_buffer.end_frame();
+	std::vector<SkinnedVertex> skinned(compute_skinner.get_skinned_vertex_count());
+	glGetNamedBufferSubData(compute_skinner.get_output_buffer_id(), 0, (long)(skinned.size() * sizeof(SkinnedVertex)),
+							skinned.data());
+	double compute_error = skinned.size() == reference.size() ? 0.0 : INFINITY;
+	for (size_t i = 0; i < std::min(skinned.size(), reference.size()); i++) {
+	  auto error = glm::abs(glm::dvec3(skinned[i].pos) - reference[i]);
+	  compute_error = std::max({compute_error, error.x, error.y, error.z});
+	}
+
+	// The vertex shader path is drawn exactly like it is rendered, with every shader variant, but only its output
+	// positions are kept
+	double vertex_shader_error = INFINITY;
+	std::map<unsigned int, unsigned int> capture_programs;
+	bool capture_programs_linked = true;
+	for (auto influence_count : SKINNING_INFLUENCE_COUNTS) {
+	  capture_programs[influence_count] = create_capture_program("../shaders/skeletal_animation_instanced.vert.glsl",
+																 Renderer::get_skinning_defines(influence_count));
+	  capture_programs_linked = capture_programs_linked && capture_programs[influence_count] != 0;
+	}
+	if (capture_programs_linked) {
+	  size_t captured_count = 0;
+	  for (const auto &mesh : model.mesh_list) {
+		captured_count += mesh.indices.size() * instance_count;
+	  }
+	  unsigned int capture_buffer;
+	  glCreateBuffers(1, &capture_buffer);
+	  glNamedBufferStorage(capture_buffer, (long)(captured_count * sizeof(glm::vec4)), nullptr, 0);
+
+	  // The program can not change while transform feedback is active, so the capture is restarted after the last
+	  // captured vertex whenever the renderer switches to another variant
+	  unsigned int primitives_query;
+	  glCreateQueries(GL_TRANSFORM_FEEDBACK_PRIMITIVES_WRITTEN, 1, &primitives_query);
+	  size_t captured_vertices = 0;
+	  bool capturing = false;
+	  auto end_capture = [&]() {
+		if (!capturing) {
+		  return;
+		}
+		glEndTransformFeedback();
+		glEndQuery(GL_TRANSFORM_FEEDBACK_PRIMITIVES_WRITTEN);
+		GLuint primitives = 0;
+		glGetQueryObjectuiv(primitives_query, GL_QUERY_RESULT, &primitives);
+		captured_vertices += primitives * 3;
+		capturing = false;
+	  };
+
+	  glEnable(GL_RASTERIZER_DISCARD);
+	  ring_buffer.begin_frame();
+	  Renderer::render_instances(instances, ring_buffer, [&](unsigned int influence_count) {
+		end_capture();
+		glUseProgram(capture_programs[influence_count]);
+		glBindBufferRange(GL_TRANSFORM_FEEDBACK_BUFFER, 0, capture_buffer, (long)(captured_vertices * sizeof(glm::vec4)),
+						  (long)((captured_count - captured_vertices) * sizeof(glm::vec4)));
+		glBeginQuery(GL_TRANSFORM_FEEDBACK_PRIMITIVES_WRITTEN, primitives_query);
+		glBeginTransformFeedback(GL_TRIANGLES);
+		capturing = true;
+	  });
+	  end_capture();
+	  ring_buffer.end_frame();
+	  glDisable(GL_RASTERIZER_DISCARD);
+	  glDeleteQueries(1, &primitives_query);
+
+	  std::vector<glm::vec4> captured(captured_count);
+	  glGetNamedBufferSubData(capture_buffer, 0, (long)(captured_count * sizeof(glm::vec4)), captured.data());
+
+	  // Every command draws one mesh for all instances, & every instance emits one vertex per index. The meshes are
+	  // drawn group by group
+	  std::vector<size_t> mesh_order(model.mesh_list.size());
+	  std::iota(mesh_order.begin(), mesh_order.end(), 0);
+	  std::stable_sort(mesh_order.begin(), mesh_order.end(), [&model](size_t a, size_t b) {
+		return Renderer::get_command_group(model.mesh_list[a]) < Renderer::get_command_group(model.mesh_list[b]);
+	  });
+	  vertex_shader_error = captured_vertices == captured_count ? 0.0 : INFINITY;
+	  size_t captured_index = 0;
+	  for (auto mesh_index : mesh_order) {
+		for (int instance_index = 0; instance_index < instance_count; instance_index++) {
+		  size_t instance_offset = instance_index * vertices_per_instance + mesh_vertex_offsets[mesh_index];
+		  for (auto index : model.mesh_list[mesh_index].indices) {
+			auto error = glm::abs(glm::dvec3(captured[captured_index++]) - reference[instance_offset + index]);
+			vertex_shader_error = std::max({vertex_shader_error, error.x, error.y, error.z});
+		  }
+		}
+	  }
+
+	  glDeleteBuffers(1, &capture_buffer);
+	}
+	for (const auto &[influence_count, capture_program] : capture_programs) {
+	  glDeleteProgram(capture_program);
+	}
+
+	auto start = std::chrono::steady_clock::now();
+	for (int frame = 0; frame < frame_count; frame++) {
+	  ring_buffer.begin_frame();
+	  compute_skinner.skin(instances, ring_buffer);
+	  ring_buffer.end_frame();
+	}
+	glFinish();
+	std::chrono::duration<double> elapsed = std::chrono::steady_clock::now() - start;
+
+	std::cout << instance_count << " instances, " << compute_skinner.get_skinned_vertex_count() << " vertices: "
+			  << elapsed.count() * 1000.0 / frame_count << " ms per frame, "
+			  << compute_skinner.get_skinned_vertex_count() * frame_count / elapsed.count() / 1e6
+			  << " million vertices per second\n";
+	std::cout << "Max error against the CPU reference: compute " << compute_error << ", vertex shader "
+			  << vertex_shader_error << "\n";
+	valid = compute_error <= MAX_SKINNING_ERROR && vertex_shader_error <= MAX_SKINNING_ERROR;
+  }
+
+  destroy_offscreen_context(window);
+  return valid ? 0 : 1;
+}
@@ -0,0 +1,107 @@
+//
+// Created by tor on 10/19/26.
+//
+
+#include <algorithm>
+#include <chrono>
+#include <iostream>
+#include <glm/gtc/matrix_transform.hpp>
+#include "Benchmark.h"
+#include "animation/AnimatedModelLoader.h"
+#include "animation/AnimationInstance.h"
+#include "animation/CpuSkinner.h"
+
+static const char *get_simd_level_name(SimdLevel simd_level) {
+  switch (simd_level) {
+	case SimdLevel::SCALAR: return "scalar";
+	case SimdLevel::SSE: return "SSE";
+	case SimdLevel::AVX2: return "AVX2";
+  }
+  return "unknown";
+}
+
+// Skins a crowd on the CPU with every supported instruction set, on one thread and on every hardware thread.
+// Reports the vertices skinned per second (in total & per thread) and exits with a non-zero status if any
+// configuration differs from the double precision reference by more than MAX_SKINNING_ERROR. Runs without a GPU.
+int run_cpu_skinning_benchmark(const std::vector<std::string> &args) {
+  const int instance_count = get_int_option(args, "--instances", 64);
+  const int frame_count = get_int_option(args, "--frames", 20);
+
+  auto model_opt = AnimatedModelLoader::load_model("../assets/character.fbx", "../assets/run.fbx");
+  if (!model_opt) {
+	std::cerr << "Could not load the character model\n";
+	return 1;
+  }
+  auto model = *model_opt;
+
+  std::vector<AnimationInstance> instances;
+  instances.reserve(instance_count);
+  std::vector<std::vector<glm::mat4>> palettes;
+  for (int i = 0; i < instance_count; i++) {
+	glm::vec3 position{(float)(i % 8) * 2.0f, 0.0f, (float)(i / 8) * 2.0f};
+	glm::mat4 model_matrix = glm::scale(glm::translate(glm::mat4(1.0f), position), glm::vec3(0.01f));
+	auto &instance = instances.emplace_back(&model, model_matrix);
+	instance.update(0.37 * i);
+	auto &palette = palettes.emplace_back(model.get_palette_size());
+	instance.write_render_skinning_matrices(palette.data());
+  }
+
+  size_t vertices_per_instance = 0;
+  for (const auto &mesh : model.mesh_list) {
+	vertices_per_instance += mesh.vertices.size();
+  }
+  std::vector<glm::vec3> skinned(instance_count * vertices_per_instance);
+
+  std::vector<glm::dvec3> reference;
+  reference.reserve(skinned.size());
+  for (int i = 0; i < instance_count; i++) {
+	for (const auto &mesh : model.mesh_list) {
+	  const glm::mat4 *mesh_palette = palettes[i].data() + mesh.palette_offset;
+	  for (const auto &vertex : mesh.vertices) {
+		reference.push_back(skin_vertex_reference(vertex, mesh_palette, instances[i].model_matrix));
+	  }
+	}
+  }
+
+  std::cout << instance_count << " instances, " << skinned.size() << " vertices per frame\n";
+  bool valid = true;
+  std::vector<unsigned int> thread_counts{1};
+  if (std::thread::hardware_concurrency() > 1) {
+	thread_counts.push_back(std::thread::hardware_concurrency());
+  }
+  for (auto simd_level : {SimdLevel::SCALAR, SimdLevel::SSE, SimdLevel::AVX2}) {
+	if (simd_level > CpuSkinner::get_best_simd_level()) {
+	  continue;
+	}
+	for (unsigned int thread_count : thread_counts) {
+	  CpuSkinner skinner{thread_count, simd_level};
+
+	  auto start = std::chrono::steady_clock::now();
+	  for (int frame = 0; frame < frame_count; frame++) {
+		glm::vec3 *out = skinned.data();
+		for (int i = 0; i < instance_count; i++) {
+		  for (const auto &mesh : model.mesh_list) {
+			skinner.skin(mesh.vertices, palettes[i].data() + mesh.palette_offset, mesh.bone_palette.size(), out,
+						 instances[i].model_matrix);
+			out += mesh.vertices.size();
+		  }
+		}
+	  }
+	  std::chrono::duration<double> elapsed = std::chrono::steady_clock::now() - start;
+
+	  double max_error = 0.0;
+	  for (size_t i = 0; i < skinned.size(); i++) {
+		auto error = glm::abs(glm::dvec3(skinned[i]) - reference[i]);
+		max_error = std::max({max_error, error.x, error.y, error.z});
+	  }
+	  valid = valid && max_error <= MAX_SKINNING_ERROR;
+
+	  const double vertices_per_second = (double)skinned.size() * frame_count / elapsed.count();
+	  std::cout << "  " << get_simd_level_name(simd_level) << ", " << thread_count << " threads: "
+				<< vertices_per_second / 1e6 << " million vertices per second ("
+				<< vertices_per_second / thread_count / 1e6 << " per thread), max error " << max_error << "\n";
+	}
+  }
+
+  return valid ? 0 : 1;
+}
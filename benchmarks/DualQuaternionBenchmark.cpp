@@ -0,0 +1,100 @@
+//
+// Created by tor on 10/19/26.
+//
+
+#include <algorithm>
+#include <cmath>
+#include <iostream>
+#include <glm/gtc/matrix_transform.hpp>
+#include "Benchmark.h"
+#include "animation/AnimatedModelLoader.h"
+#include "animation/DualQuaternion.h"
+
+// Skins a vertex the same way as the DUAL_QUATERNION_SKINNING variant of skeletal_animation_instanced.vert.glsl
+static glm::dvec3 skin_vertex_dual_quaternion(const AnimatedVertex &vertex,
+											  const DualQuaternion *palette,
+											  const glm::mat4 &model_matrix) {
+  glm::dvec4 real{0.0};
+  glm::dvec4 dual{0.0};
+  for (int i = 0; i < MAX_BONE_PER_VERTEX; i++) {
+	if (vertex.bone_ids[i] == -1) {
+	  continue;
+	}
+	const auto &bone = palette[vertex.bone_ids[i]];
+	double weight = glm::dot(real, glm::dvec4(bone.real)) < 0.0 ? -vertex.bone_weights[i] : vertex.bone_weights[i];
+	real += glm::dvec4(bone.real) * weight;
+	dual += glm::dvec4(bone.dual) * weight;
+  }
+
+  const double length = std::max(glm::length(real), 1e-8);
+  DualQuaternion blended;
+  blended.real = glm::vec4(real / length);
+  blended.dual = glm::vec4(dual / length);
+  return glm::dvec3(glm::dmat4(model_matrix) * glm::dvec4(blended.transform_point(vertex.pos), 1.0));
+}
+
+// Samples run.fbx throughout the clip and compares dual quaternion skinning against the matrix (linear blend) path.
+// Vertices that follow a single bone must end up in the same place with both, since the only difference is how
+// bones are blended, otherwise the skinning matrices are not rigid & the benchmark exits with a non-zero status.
+// Also reports how far the blended vertices move & the palette size of either path. Runs without a GPU.
+int run_dual_quaternion_benchmark(const std::vector<std::string> &args) {
+  const int sample_count = get_int_option(args, "--samples", 50);
+
+  auto model_opt = AnimatedModelLoader::load_model("../assets/character.fbx", "../assets/run.fbx");
+  if (!model_opt) {
+	std::cerr << "Could not load the character model\n";
+	return 1;
+  }
+  const auto &model = *model_opt;
+  const glm::mat4 model_matrix = glm::scale(glm::mat4(1.0f), glm::vec3(0.01f));
+
+  std::vector<glm::mat4> skinning_matrices = model.skinning_matrices;
+  std::vector<glm::mat4> palette(model.get_palette_size());
+  std::vector<DualQuaternion> dual_quaternions(palette.size());
+  double max_rigid_error = 0.0;
+  double max_blended_difference = 0.0;
+  double blended_difference_sum = 0.0;
+  size_t blended_count = 0;
+  for (int sample = 0; sample < sample_count; sample++) {
+	model.evaluate_pose(model.animation_duration * sample / sample_count, skinning_matrices);
+	model.gather_palette(skinning_matrices.data(), palette.data());
+	convert_palette(palette.data(), dual_quaternions.data(), dual_quaternions.size());
+
+	for (const auto &mesh : model.mesh_list) {
+	  for (const auto &vertex : mesh.vertices) {
+		const auto difference = glm::length(
+			skin_vertex_reference(vertex, palette.data() + mesh.palette_offset, model_matrix)
+				- skin_vertex_dual_quaternion(vertex, dual_quaternions.data() + mesh.palette_offset, model_matrix));
+		int influence_count = 0;
+		for (int i = 0; i < MAX_BONE_PER_VERTEX; i++) {
+		  influence_count += vertex.bone_ids[i] >= 0 && vertex.bone_weights[i] != 0.0f;
+		}
+		// Unweighted vertices collapse to the origin with matrices but keep their bind pose with dual quaternions,
+		// which says nothing about how either path blends
+		if (influence_count == 0) {
+		  continue;
+		}
+		if (influence_count == 1) {
+		  max_rigid_error = std::max(max_rigid_error, difference);
+		} else {
+		  max_blended_difference = std::max(max_blended_difference, difference);
+		  blended_difference_sum += difference;
+		  blended_count++;
+		}
+	  }
+	}
+  }
+
+  std::cout << sample_count << " poses of run.fbx\n";
+  std::cout << "Max error of rigidly skinned vertices: " << max_rigid_error << "\n";
+  std::cout << "Difference of blended vertices from linear blend skinning: max " << max_blended_difference
+			<< ", mean " << (blended_count > 0 ? blended_difference_sum / (double)blended_count : 0.0) << "\n";
+  std::cout << "Palette per instance: " << palette.size() * sizeof(glm::mat4) << " bytes of matrices, "
+			<< palette.size() * sizeof(DualQuaternion) << " bytes of dual quaternions\n";
+
+  if (max_rigid_error > MAX_SKINNING_ERROR) {
+	std::cerr << "Dual quaternion skinning differs from matrix skinning by more than " << MAX_SKINNING_ERROR << "\n";
+	return 1;
+  }
+  return 0;
+}
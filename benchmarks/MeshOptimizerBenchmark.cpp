@@ -0,0 +1,81 @@
+//
+// Created by tor on 10/19/26.
+//
+
+#include <algorithm>
+#include <array>
+#include <chrono>
+#include <iomanip>
+#include <iostream>
+#include "Benchmark.h"
+#include "animation/AnimatedModelLoader.h"
+#include "animation/MeshOptimizer.h"
+
+static void print_stats(const char *name, const VertexCacheStats &stats) {
+  std::cout << "  " << std::left << std::setw(20) << name << std::right << std::fixed << std::setprecision(3)
+			<< "ACMR " << stats.acmr << ", ATVR " << stats.atvr << "\n";
+}
+
+// Loads the character without optimizing its meshes & reports the ACMR/ATVR of every mesh in the original order,
+// after the vertex cache optimization and after the overdraw optimization. Exits with a non-zero status if an
+// optimized mesh no longer contains the same triangles. Runs without a GPU.
+int run_mesh_optimizer_benchmark(const std::vector<std::string> &args) {
+  const int cache_size = get_int_option(args, "--cache-size", (int)MeshOptimizer::ANALYSIS_CACHE_SIZE);
+
+  auto model_opt = AnimatedModelLoader::load_model("../assets/character.fbx", "../assets/run.fbx", false);
+  if (!model_opt) {
+	std::cerr << "Could not load the character model\n";
+	return 1;
+  }
+
+  bool valid = true;
+  for (size_t i = 0; i < model_opt->mesh_list.size(); i++) {
+	const auto &original = model_opt->mesh_list[i];
+	std::cout << "Mesh " << i << ": " << original.vertices.size() << " vertices, " << original.indices.size() / 3
+			  << " triangles (" << cache_size << " entry FIFO cache)\n";
+	print_stats("original", MeshOptimizer::analyze_vertex_cache(original.indices, original.vertices.size(),
+																 cache_size));
+
+	Mesh cache_optimized = original;
+	auto start = std::chrono::steady_clock::now();
+	MeshOptimizer::optimize(cache_optimized, false);
+	auto cache_time = std::chrono::duration<double, std::milli>(std::chrono::steady_clock::now() - start).count();
+	print_stats("vertex cache", MeshOptimizer::analyze_vertex_cache(cache_optimized.indices,
+																	 cache_optimized.vertices.size(),
+																	 cache_size));
+
+	Mesh overdraw_optimized = original;
+	start = std::chrono::steady_clock::now();
+	MeshOptimizer::optimize(overdraw_optimized, true);
+	auto overdraw_time = std::chrono::duration<double, std::milli>(std::chrono::steady_clock::now() - start).count();
+	print_stats("+ overdraw", MeshOptimizer::analyze_vertex_cache(overdraw_optimized.indices,
+																   overdraw_optimized.vertices.size(),
+																   cache_size));
+	std::cout << "  optimized in " << std::setprecision(2) << cache_time << " ms (" << overdraw_time
+			  << " ms with overdraw)\n";
+
+	// Every optimization only reorders, so the positions of the triangles must be unchanged
+	auto sorted_triangles = [](const Mesh &mesh) {
+	  std::vector<std::array<float, 9>> triangles;
+	  for (size_t t = 0; t + 2 < mesh.indices.size(); t += 3) {
+		std::array<float, 9> triangle{};
+		for (int corner = 0; corner < 3; corner++) {
+		  const auto &pos = mesh.vertices[mesh.indices[t + corner]].pos;
+		  triangle[corner * 3] = pos.x;
+		  triangle[corner * 3 + 1] = pos.y;
+		  triangle[corner * 3 + 2] = pos.z;
+		}
+		triangles.push_back(triangle);
+	  }
+	  std::sort(triangles.begin(), triangles.end());
+	  return triangles;
+	};
+	auto expected = sorted_triangles(original);
+	if (sorted_triangles(cache_optimized) != expected || sorted_triangles(overdraw_optimized) != expected) {
+	  std::cerr << "Mesh " << i << " has different triangles after being optimized\n";
+	  valid = false;
+	}
+  }
+
+  return valid ? 0 : 1;
+}
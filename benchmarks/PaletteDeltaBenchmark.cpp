@@ -0,0 +1,115 @@
+//
+// Created by tor on 10/19/26.
+//
+
+#include <algorithm>
+#include <chrono>
+#include <cstring>
+#include <iostream>
+#include "Benchmark.h"
+#include "animation/AnimatedModelLoader.h"
+#include "animation/AnimationScheduler.h"
+#include "renderer/PaletteBuffer.h"
+
+// Updates a crowd the way the scheduler's LODs do, where instances are updated every 1, 2, 4 or 8 ticks & the
+// distant half freezes its least influential bones, & uploads the palettes to a PaletteBuffer. This runs twice: once
+// uploading only on ticks, & once like the demo, where the palettes are interpolated & uploaded every rendered frame
+// (--frames-per-tick), which changes every moving bone each frame. Reports the size of the draw palette against the
+// bone count & the bytes & ranges uploaded per frame against a full upload, & exits with a non-zero status if the
+// buffer's contents (read back for a sample of the ticks) differ from the palettes that were written.
+int run_palette_delta_benchmark(const std::vector<std::string> &args) {
+  const int instance_count = get_int_option(args, "--instances", 1000);
+  const int tick_count = get_int_option(args, "--ticks", 300);
+  const int frames_per_tick = std::max(get_int_option(args, "--frames-per-tick", 2), 1);
+  const double tick_length = 1.0 / 30.0;
+
+  GLFWwindow *window = create_offscreen_context();
+  if (window == nullptr) {
+	return 1;
+  }
+
+  auto model = AnimatedModelLoader::load_model("../assets/character.fbx", "../assets/run.fbx");
+  if (!model) {
+	std::cerr << "Could not load the character model\n";
+	destroy_offscreen_context(window);
+	return 1;
+  }
+  model->bone_lod_levels.push_back(BoneLod::generate_from_influence(*model, 0.02f));
+  // Bones shared by meshes with different local palettes are uploaded once per palette
+  std::cout << model->get_palette_size() << " palette entries per instance for " << model->get_bone_count()
+			<< " bones in " << model->mesh_list.size() << " meshes\n";
+
+  // The scheduler is only used to interpolate, like the demo does every rendered frame
+  AnimationScheduler scheduler{0.0};
+  scheduler.set_update_rate_lod(UpdateRateLod({{0.0f, 1}}, SkippedFrameMode::INTERPOLATE_PALETTES));
+
+  int mismatches = 0;
+  for (bool interpolate : {false, true}) {
+	std::vector<AnimationInstance> instances;
+	instances.reserve(instance_count);
+	for (int i = 0; i < instance_count; i++) {
+	  auto &instance = instances.emplace_back(&*model, glm::mat4(1.0f));
+	  instance.animation_time = model->advance_time(0.0, 0.37 * i);
+	  instance.update_interval = 1u << (i % 4);
+	  instance.bone_lod = i < instance_count / 2 ? 0 : 1;
+	  instance.update(0.0);
+	}
+
+	PaletteBuffer palette_buffer{};
+	size_t uploaded_bytes = 0;
+	size_t uploaded_ranges = 0;
+	size_t upload_count = 0;
+	std::vector<unsigned char> expected;
+	std::vector<unsigned char> actual;
+
+	auto start = std::chrono::steady_clock::now();
+	for (int tick = 0; tick < tick_count; tick++) {
+	  for (auto &instance : instances) {
+		if (++instance.frames_since_update >= instance.update_interval) {
+		  instance.update(tick_length);
+		} else {
+		  instance.pending_delta_time += tick_length;
+		}
+	  }
+
+	  // Without interpolation the palettes only change on ticks, otherwise every frame in between is uploaded too
+	  const int frames = interpolate ? frames_per_tick : 1;
+	  for (int frame = 0; frame < frames; frame++) {
+		if (interpolate) {
+		  scheduler.interpolate(instances, (double)frame / frames);
+		}
+		palette_buffer.upload(instances, SkinningMode::LINEAR_BLEND);
+		uploaded_bytes += palette_buffer.get_uploaded_bytes();
+		uploaded_ranges += palette_buffer.get_uploaded_range_count();
+		upload_count++;
+	  }
+
+	  // Reading back forces a full sync, only do that for a sample of the ticks
+	  if (tick % 10 == 0) {
+		expected.resize(palette_buffer.get_palette_bytes());
+		actual.resize(expected.size());
+		for (size_t i = 0; i < instances.size(); i++) {
+		  instances[i].write_render_skinning_matrices(
+			  (glm::mat4 *)expected.data() + palette_buffer.get_palette_offset(i));
+		}
+		glGetNamedBufferSubData(palette_buffer.get_buffer_id(), 0, (long)actual.size(), actual.data());
+		if (actual != expected) {
+		  std::cerr << "Tick " << tick << " does not match the palettes that were written\n";
+		  mismatches++;
+		}
+	  }
+	}
+	glFinish();
+	std::chrono::duration<double, std::micro> elapsed = std::chrono::steady_clock::now() - start;
+
+	std::cout << (interpolate ? "Interpolated, " + std::to_string(frames_per_tick) + " frames per tick: "
+							  : std::string("Ticks only: "))
+			  << instance_count << " instances, " << tick_count << " ticks: " << uploaded_bytes / upload_count / 1024
+			  << " KB of " << palette_buffer.get_palette_bytes() / 1024 << " KB uploaded per frame in "
+			  << (double)uploaded_ranges / upload_count << " ranges, " << elapsed.count() / upload_count
+			  << " us per frame (including updates), " << mismatches << " mismatches\n";
+  }
+
+  destroy_offscreen_context(window);
+  return mismatches == 0 ? 0 : 1;
+}
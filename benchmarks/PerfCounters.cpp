@@ -0,0 +1,78 @@
+//
+// Created by tor on 10/19/26.
+//
+
+#include "PerfCounters.h"
+
+#ifdef __linux__
+#include <linux/perf_event.h>
+#include <sys/ioctl.h>
+#include <sys/syscall.h>
+#include <unistd.h>
+
+static int open_counter(uint32_t type, uint64_t config) {
+  perf_event_attr attributes{};
+  attributes.type = type;
+  attributes.size = sizeof(perf_event_attr);
+  attributes.config = config;
+  attributes.disabled = 1;
+  attributes.exclude_kernel = 1;
+  attributes.exclude_hv = 1;
+  // Measures the calling thread on any CPU
+  return (int)syscall(__NR_perf_event_open, &attributes, 0, -1, -1, 0);
+}
+
+PerfCounters::PerfCounters() {
+  const uint64_t l1d_read_miss = PERF_COUNT_HW_CACHE_L1D
+	  | (PERF_COUNT_HW_CACHE_OP_READ << 8)
+	  | (PERF_COUNT_HW_CACHE_RESULT_MISS << 16);
+  const std::vector<std::pair<std::string, std::pair<uint32_t, uint64_t>>> events{
+	  {"instructions", {PERF_TYPE_HARDWARE, PERF_COUNT_HW_INSTRUCTIONS}},
+	  {"cache-references", {PERF_TYPE_HARDWARE, PERF_COUNT_HW_CACHE_REFERENCES}},
+	  {"cache-misses", {PERF_TYPE_HARDWARE, PERF_COUNT_HW_CACHE_MISSES}},
+	  {"L1-dcache-load-misses", {PERF_TYPE_HW_CACHE, l1d_read_miss}},
+  };
+
+  for (const auto &[name, event] : events) {
+	int fd = open_counter(event.first, event.second);
+	if (fd >= 0) {
+	  counters.push_back({name, fd, 0});
+	}
+  }
+}
+
+PerfCounters::~PerfCounters() {
+  for (const auto &counter : counters) {
+	close(counter.fd);
+  }
+}
+
+void PerfCounters::start() {
+  for (const auto &counter : counters) {
+	ioctl(counter.fd, PERF_EVENT_IOC_RESET, 0);
+	ioctl(counter.fd, PERF_EVENT_IOC_ENABLE, 0);
+  }
+}
+
+void PerfCounters::stop() {
+  for (auto &counter : counters) {
+	ioctl(counter.fd, PERF_EVENT_IOC_DISABLE, 0);
+	if (read(counter.fd, &counter.value, sizeof(uint64_t)) != sizeof(uint64_t)) {
+	  counter.value = 0;
+	}
+  }
+}
+#else
+PerfCounters::PerfCounters() = default;
+PerfCounters::~PerfCounters() = default;
+void PerfCounters::start() {}
+void PerfCounters::stop() {}
+#endif
+
+std::vector<std::pair<std::string, uint64_t>> PerfCounters::get_results() const {
+  std::vector<std::pair<std::string, uint64_t>> results;
+  for (const auto &counter : counters) {
+	results.emplace_back(counter.name, counter.value);
+  }
+  return results;
+}
@@ -0,0 +1,41 @@
+//
+// Created by tor on 10/19/26.
+//
+
+#ifndef OPENGL_SKELETAL_ANIMATION_BENCHMARKS_PERFCOUNTERS_H_
+#define OPENGL_SKELETAL_ANIMATION_BENCHMARKS_PERFCOUNTERS_H_
+
+#include <cstdint>
+#include <string>
+#include <utility>
+#include <vector>
+
+// Hardware performance counters (cache misses etc.) of the calling thread, read through Linux' perf_event_open.
+// Counters that are not available, e.g. inside a VM or due to kernel.perf_event_paranoid, are left out.
+class PerfCounters {
+ public:
+  PerfCounters();
+  ~PerfCounters();
+  PerfCounters(const PerfCounters &) = delete;
+  PerfCounters &operator=(const PerfCounters &) = delete;
+
+  void start();
+  void stop();
+
+  // The counter values measured between the last start() & stop() pair, by counter name
+  [[nodiscard]] std::vector<std::pair<std::string, uint64_t>> get_results() const;
+
+  [[nodiscard]] bool is_available() const {
+	return !counters.empty();
+  }
+
+ private:
+  struct Counter {
+	std::string name;
+	int fd;
+	uint64_t value;
+  };
+  std::vector<Counter> counters{};
+};
+
+#endif //OPENGL_SKELETAL_ANIMATION_BENCHMARKS_PERFCOUNTERS_H_
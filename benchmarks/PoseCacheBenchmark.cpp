@@ -0,0 +1,73 @@
+//
+// Created by tor on 10/19/26.
+//
+
+#include <chrono>
+#include <iostream>
+#include <limits>
+#include <random>
+#include <glm/gtc/matrix_transform.hpp>
+#include "Benchmark.h"
+#include "animation/AnimatedModelLoader.h"
+#include "animation/AnimationScheduler.h"
+
+// Updates a crowd without a pose cache and with caches of different quantization steps, and reports the time
+// per tick together with the cache's hit rate, memory use and the error introduced by the quantization.
+int run_pose_cache_benchmark(const std::vector<std::string> &args) {
+  const int instance_count = get_int_option(args, "--instances", 5000);
+  const int tick_count = get_int_option(args, "--ticks", 100);
+  const int memory_cap_kb = get_int_option(args, "--memory-cap-kb", 4096);
+  const double tick_length = 1.0 / 30.0;
+
+  GLFWwindow *window = create_offscreen_context();
+  if (window == nullptr) {
+	return 1;
+  }
+
+  auto model = AnimatedModelLoader::load_model("../assets/character.fbx", "../assets/run.fbx");
+  if (!model) {
+	std::cerr << "Could not load the character model\n";
+	destroy_offscreen_context(window);
+	return 1;
+  }
+
+  std::mt19937 random(42);
+  std::uniform_real_distribution<double> phase(0.0, 1.0);
+  std::vector<AnimationInstance> instances;
+  instances.reserve(instance_count);
+  for (int i = 0; i < instance_count; i++) {
+	glm::mat4 model_matrix = glm::translate(glm::mat4(1.0f), glm::vec3((float)(i % 100), 0.0f, (float)(i / 100)));
+	auto &instance = instances.emplace_back(&*model, glm::scale(model_matrix, glm::vec3(0.01f)));
+	instance.animation_time = phase(random) * model->animation_duration;
+  }
+
+  std::cout << instance_count << " instances, " << tick_count << " ticks, " << memory_cap_kb << " KB cache\n";
+  // A step of 0 runs without a cache
+  for (double time_step : {0.0, 1.0 / 120.0, 1.0 / 60.0, 1.0 / 30.0}) {
+	auto run_instances = instances;
+	PoseCache pose_cache{time_step, (size_t)memory_cap_kb * 1024};
+	AnimationScheduler scheduler{std::numeric_limits<double>::max()};
+	scheduler.set_pose_cache(time_step > 0.0 ? &pose_cache : nullptr);
+
+	auto start = std::chrono::steady_clock::now();
+	for (int tick = 0; tick < tick_count; tick++) {
+	  scheduler.update(run_instances, tick_length, {0.0f, 2.0f, 0.0f});
+	}
+	std::chrono::duration<double, std::milli> elapsed = std::chrono::steady_clock::now() - start;
+
+	if (time_step == 0.0) {
+	  std::cout << "No cache: " << elapsed.count() / tick_count << " ms per tick\n";
+	  continue;
+	}
+	const auto &stats = pose_cache.get_stats();
+	std::cout << "Step " << time_step * 1000.0 << " ms: " << elapsed.count() / tick_count << " ms per tick, "
+			  << stats.get_hit_rate() * 100.0 << "% hits, "
+			  << stats.entry_count << " entries (" << stats.memory_bytes / 1024 << " KB), "
+			  << stats.evictions << " evictions, time error mean " << stats.get_mean_time_error() * 1000.0
+			  << " ms / max " << stats.max_time_error * 1000.0 << " ms, max palette error "
+			  << stats.max_palette_error << "\n";
+  }
+
+  destroy_offscreen_context(window);
+  return 0;
+}
@@ -0,0 +1,80 @@
+//
+// Created by tor on 10/19/26.
+//
+
+#include <chrono>
+#include <iostream>
+#include "Benchmark.h"
+#include "renderer/RingBuffer.h"
+
+// Writes a known pattern into the ring buffer's mapped memory for a number of frames and has the GPU copy every
+// allocation into a separate buffer, which is read back and compared. This verifies that persistently mapped,
+// coherent writes are visible to the GPU and that regions are not overwritten while in flight. Works with Mesa's
+// software renderer (LIBGL_ALWAYS_SOFTWARE=1).
+int run_ring_buffer_benchmark(const std::vector<std::string> &args) {
+  const int frame_count = get_int_option(args, "--frames", 300);
+  const int allocations_per_frame = get_int_option(args, "--allocations", 64);
+  const size_t allocation_size = (size_t)get_int_option(args, "--allocation-size", 4096);
+
+  GLFWwindow *window = create_offscreen_context();
+  if (window == nullptr) {
+	return 1;
+  }
+
+  int mismatches = 0;
+  {
+	RingBuffer ring_buffer{allocations_per_frame * (allocation_size + 256)};
+	const size_t frame_bytes = allocations_per_frame * allocation_size;
+
+	// The GPU copies the whole frame here, the CPU then reads it back
+	unsigned int readback_buffer;
+	glCreateBuffers(1, &readback_buffer);
+	glNamedBufferStorage(readback_buffer, (long)frame_bytes, nullptr, GL_DYNAMIC_STORAGE_BIT);
+	std::vector<uint32_t> expected(frame_bytes / sizeof(uint32_t));
+	std::vector<uint32_t> actual(expected.size());
+
+	auto start = std::chrono::steady_clock::now();
+	for (int frame = 0; frame < frame_count; frame++) {
+	  ring_buffer.begin_frame();
+	  for (int i = 0; i < allocations_per_frame; i++) {
+		auto allocation = ring_buffer.allocate(allocation_size, ring_buffer.get_storage_alignment());
+		if (!allocation) {
+		  std::cerr << "Ran out of space in frame " << frame << "\n";
+		  mismatches++;
+		  break;
+		}
+
+		// The mapping is write-only, so the expected words are generated alongside rather than read back from it
+		auto *words = (uint32_t *)allocation->data;
+		auto *expected_words = &expected[i * allocation_size / sizeof(uint32_t)];
+		for (size_t word = 0; word < allocation_size / sizeof(uint32_t); word++) {
+		  const auto value = (uint32_t)(frame * 1000003 + i * 7919 + word);
+		  words[word] = value;
+		  expected_words[word] = value;
+		}
+		glCopyNamedBufferSubData(ring_buffer.get_buffer_id(), readback_buffer, (long)allocation->offset,
+								 (long)(i * allocation_size), (long)allocation_size);
+	  }
+	  ring_buffer.end_frame();
+
+	  // Reading back every frame forces a full sync, only do that for a sample of the frames
+	  if (frame % 10 == 0) {
+		glGetNamedBufferSubData(readback_buffer, 0, (long)frame_bytes, actual.data());
+		if (actual != expected) {
+		  std::cerr << "Frame " << frame << " does not match what was written\n";
+		  mismatches++;
+		}
+	  }
+	}
+	glFinish();
+	std::chrono::duration<double, std::milli> elapsed = std::chrono::steady_clock::now() - start;
+
+	std::cout << frame_count << " frames of " << allocations_per_frame << " x " << allocation_size << " bytes: "
+			  << elapsed.count() / frame_count << " ms per frame, " << ring_buffer.get_wait_count()
+			  << " fence waits, " << mismatches << " mismatches\n";
+	glDeleteBuffers(1, &readback_buffer);
+  }
+
+  destroy_offscreen_context(window);
+  return mismatches == 0 ? 0 : 1;
+}
@@ -0,0 +1,170 @@
+//
+// Created by tor on 10/19/26.
+//
+
+#include <algorithm>
+#include <chrono>
+#include <cmath>
+#include <iostream>
+#include <glm/gtc/matrix_transform.hpp>
+#include "Benchmark.h"
+#include "animation/AnimatedModelLoader.h"
+#include "renderer/MeshArena.h"
+#include "renderer/StaticPoseCache.h"
+
+// Animates a crowd where every n-th instance stands still & passes it through a StaticPoseCache every tick. Half of
+// the idle instances resume a third of the way in & stop again after two thirds, so they are released & baked a
+// second time. Some of the others are never paused but keep evaluating the same pose (their clip does not advance),
+// which has to be detected & baked as well. Reports how many instances were baked, the vertices that no longer need
+// skinning each tick & the time spent checking & baking poses. Exits with a non-zero status if a resumed instance
+// stays baked, a still instance is not baked in the end, a running one is, or a baked vertex (read back from the
+// GPU) differs from the reference by more than MAX_SKINNING_ERROR.
+int run_static_pose_benchmark(const std::vector<std::string> &args) {
+  const int instance_count = get_int_option(args, "--instances", 1000);
+  // Every phase needs enough ticks for the idle instances to be baked
+  const int tick_count = std::max(get_int_option(args, "--ticks", 300),
+								  3 * ((int)StaticPoseCache::DEFAULT_FREEZE_FRAMES + 2));
+  const int idle_interval = std::max(get_int_option(args, "--idle-interval", 2), 1);
+  const double tick_length = 1.0 / 30.0;
+
+  GLFWwindow *window = create_offscreen_context();
+  if (window == nullptr) {
+	return 1;
+  }
+
+  auto model = AnimatedModelLoader::load_model("../assets/character.fbx", "../assets/run.fbx");
+  if (!model) {
+	std::cerr << "Could not load the character model\n";
+	destroy_offscreen_context(window);
+	return 1;
+  }
+  size_t vertices_per_instance = 0;
+  for (const auto &mesh : model->mesh_list) {
+	vertices_per_instance += mesh.vertices.size();
+  }
+
+  int errors = 0;
+  {
+	MeshArena mesh_arena{};
+	mesh_arena.add_model(*model);
+
+	std::vector<AnimationInstance> instances;
+	instances.reserve(instance_count);
+	for (int i = 0; i < instance_count; i++) {
+	  glm::vec3 position{(float)(i % 8) * 2.0f, 0.0f, (float)(i / 8) * 2.0f};
+	  glm::mat4 model_matrix = glm::translate(glm::mat4(1.0f), position);
+	  model_matrix = glm::scale(model_matrix, glm::vec3(0.01f));
+	  auto &instance = instances.emplace_back(&*model, model_matrix);
+	  instance.update(0.37 * i);
+	  instance.paused = i % idle_interval == 0;
+	}
+	// Every other idle instance walks for the middle third of the run
+	auto is_resumed = [&](int i) {
+	  return i % idle_interval == 0 && (i / idle_interval) % 2 == 1;
+	};
+	const int resume_tick = tick_count / 3;
+	const int stop_tick = 2 * tick_count / 3;
+	// Some of the running instances are updated every tick without their pose ever changing
+	auto is_held = [&](int i) {
+	  return i % idle_interval != 0 && i % (2 * idle_interval) == 1;
+	};
+	size_t idle_count = 0;
+	size_t resumed_count = 0;
+	size_t held_count = 0;
+	for (int i = 0; i < instance_count; i++) {
+	  idle_count += instances[i].paused ? 1 : 0;
+	  resumed_count += is_resumed(i) ? 1 : 0;
+	  held_count += is_held(i) ? 1 : 0;
+	}
+
+	StaticPoseCache static_pose_cache{mesh_arena};
+	size_t skipped_vertices = 0;
+	double elapsed_us = 0.0;
+	for (int tick = 0; tick < tick_count; tick++) {
+	  if (tick == resume_tick || tick == stop_tick) {
+		for (int i = 0; i < instance_count; i++) {
+		  if (is_resumed(i)) {
+			instances[i].paused = tick == stop_tick;
+		  }
+		}
+	  }
+	  for (int i = 0; i < instance_count; i++) {
+		if (!instances[i].paused) {
+		  instances[i].update(is_held(i) ? 0.0 : tick_length);
+		}
+	  }
+
+	  auto start = std::chrono::steady_clock::now();
+	  static_pose_cache.update(instances);
+	  elapsed_us += std::chrono::duration<double, std::micro>(std::chrono::steady_clock::now() - start).count();
+
+	  // The resumed instances have to be skinned again as soon as they move
+	  if (tick == resume_tick) {
+		for (int i = 0; i < instance_count; i++) {
+		  if (is_resumed(i) && instances[i].static_pose) {
+			errors++;
+		  }
+		}
+		if (errors > 0) {
+		  std::cerr << errors << " resumed instances are still drawn from their bake\n";
+		}
+	  }
+
+	  for (const auto &instance : instances) {
+		skipped_vertices += instance.static_pose ? vertices_per_instance : 0;
+	  }
+	}
+
+	// Only the idle & held instances may be baked, & all of them should be by now. The resumed ones were baked twice.
+	int wrong_bakes = 0;
+	for (int i = 0; i < instance_count; i++) {
+	  if (instances[i].static_pose != (instances[i].paused || is_held(i))) {
+		wrong_bakes++;
+	  }
+	}
+	if (wrong_bakes > 0) {
+	  std::cerr << wrong_bakes << " instances were baked when they should not have been, or the other way around\n";
+	}
+	const size_t expected_bakes = idle_count + resumed_count + held_count;
+	if (static_pose_cache.get_bake_count() != expected_bakes) {
+	  std::cerr << static_pose_cache.get_bake_count() << " bakes, expected " << expected_bakes << "\n";
+	  wrong_bakes++;
+	}
+	errors += wrong_bakes;
+
+	std::vector<SkinnedVertex> baked(vertices_per_instance);
+	std::vector<glm::mat4> palette(model->get_palette_size());
+	double max_error = 0.0;
+	for (size_t i = 0; i < instances.size(); i++) {
+	  auto offset = static_pose_cache.get_baked_vertex_offset(i);
+	  if (!offset) {
+		continue;
+	  }
+	  glGetNamedBufferSubData(static_pose_cache.get_vertex_buffer_id(), (long)(*offset * sizeof(SkinnedVertex)),
+							  (long)(baked.size() * sizeof(SkinnedVertex)), baked.data());
+	  instances[i].write_render_skinning_matrices(palette.data());
+	  size_t vertex = 0;
+	  for (const auto &mesh : model->mesh_list) {
+		for (const auto &source : mesh.vertices) {
+		  auto reference = skin_vertex_reference(source, palette.data() + mesh.palette_offset,
+												 instances[i].model_matrix);
+		  auto error = glm::abs(glm::dvec3(baked[vertex++].pos) - reference);
+		  max_error = std::max({max_error, error.x, error.y, error.z});
+		}
+	  }
+	}
+	if (max_error > MAX_SKINNING_ERROR) {
+	  std::cerr << "The baked vertices differ from the reference by up to " << max_error << "\n";
+	  errors++;
+	}
+
+	std::cout << instance_count << " instances, " << tick_count << " ticks: "
+			  << static_pose_cache.get_baked_instance_count() << " baked (" << static_pose_cache.get_bake_count()
+			  << " bakes, " << resumed_count << " resumed, " << held_count << " held), "
+			  << skipped_vertices / tick_count << " vertices skipped per tick, " << elapsed_us / tick_count
+			  << " us per tick, max error " << max_error << "\n";
+  }
+
+  destroy_offscreen_context(window);
+  return errors == 0 ? 0 : 1;
+}
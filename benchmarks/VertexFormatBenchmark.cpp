@@ -0,0 +1,113 @@
+//
+// Created by tor on 10/19/26.
+//
+
+#include <cmath>
+#include <iostream>
+#include <glm/gtc/matrix_transform.hpp>
+#include "Benchmark.h"
+#include "animation/AnimatedModelLoader.h"
+#include "renderer/MeshArena.h"
+#include "renderer/Renderer.h"
+#include "renderer/VertexFormat.h"
+#include "shader/Shader.h"
+
+static const char *get_format_name(VertexFormat format) {
+  switch (format) {
+	case VertexFormat::FULL: return "full";
+	case VertexFormat::PACKED: return "packed";
+  }
+  return "unknown";
+}
+
+// Draws the same crowd into an offscreen framebuffer with every vertex format, and reports the vertex & index memory
+// and the GPU time per frame (measured with timer queries).
+int run_vertex_format_benchmark(const std::vector<std::string> &args) {
+  const int instance_count = get_int_option(args, "--instances", 256);
+  const int frame_count = get_int_option(args, "--frames", 100);
+  const int resolution = get_int_option(args, "--resolution", 1024);
+
+  GLFWwindow *window = create_offscreen_context();
+  if (window == nullptr) {
+	return 1;
+  }
+
+  {
+	auto model_opt = AnimatedModelLoader::load_model("../assets/character.fbx", "../assets/run.fbx");
+	if (!model_opt) {
+	  std::cerr << "Could not load the character model\n";
+	  destroy_offscreen_context(window);
+	  return 1;
+	}
+
+	unsigned int framebuffer, color_buffer, depth_buffer;
+	glCreateRenderbuffers(1, &color_buffer);
+	glNamedRenderbufferStorage(color_buffer, GL_RGBA8, resolution, resolution);
+	glCreateRenderbuffers(1, &depth_buffer);
+	glNamedRenderbufferStorage(depth_buffer, GL_DEPTH_COMPONENT24, resolution, resolution);
+	glCreateFramebuffers(1, &framebuffer);
+	glNamedFramebufferRenderbuffer(framebuffer, GL_COLOR_ATTACHMENT0, GL_RENDERBUFFER, color_buffer);
+	glNamedFramebufferRenderbuffer(framebuffer, GL_DEPTH_ATTACHMENT, GL_RENDERBUFFER, depth_buffer);
+	glBindFramebuffer(GL_FRAMEBUFFER, framebuffer);
+	glViewport(0, 0, resolution, resolution);
+	glEnable(GL_DEPTH_TEST);
+
+	// The crowd is a square that fills most of the view
+	const int side = (int)std::ceil(std::sqrt((double)instance_count));
+	const float extent = (float)side * 2.0f;
+	ShaderPermutations skinning_shaders{"../shaders/skeletal_animation_instanced.vert.glsl",
+										"../shaders/textured.frag.glsl"};
+	for (auto influence_count : SKINNING_INFLUENCE_COUNTS) {
+	  Shader &shader = skinning_shaders.get(Renderer::get_skinning_defines(influence_count));
+	  shader.use();
+	  shader.setMat4("projection", glm::perspective(glm::radians(45.0f), 1.0f, 0.1f, extent * 4.0f));
+	  shader.setMat4("view", glm::lookAt(glm::vec3(0.0f, extent * 0.6f, extent), glm::vec3(0.0f), glm::vec3(0, 1, 0)));
+	}
+
+	unsigned int query;
+	glCreateQueries(GL_TIME_ELAPSED, 1, &query);
+	for (auto format : {VertexFormat::FULL, VertexFormat::PACKED}) {
+	  auto model = *model_opt;
+	  MeshArena mesh_arena{format};
+	  mesh_arena.add_model(model);
+
+	  std::vector<AnimationInstance> instances;
+	  instances.reserve(instance_count);
+	  for (int i = 0; i < instance_count; i++) {
+		glm::vec3 position{(float)(i % side) * 2.0f - extent / 2.0f, 0.0f, (float)(i / side) * 2.0f - extent / 2.0f};
+		glm::mat4 model_matrix = glm::scale(glm::translate(glm::mat4(1.0f), position), glm::vec3(0.01f));
+		instances.emplace_back(&model, model_matrix).update(0.37 * i);
+	  }
+	  RingBuffer ring_buffer{Renderer::get_frame_data_size(model, instances.size())};
+
+	  double gpu_ms = 0.0;
+	  for (int frame = 0; frame < frame_count; frame++) {
+		glClear(GL_COLOR_BUFFER_BIT | GL_DEPTH_BUFFER_BIT);
+		ring_buffer.begin_frame();
+		glBeginQuery(GL_TIME_ELAPSED, query);
+		Renderer::render_instances(instances, ring_buffer, skinning_shaders);
+		glEndQuery(GL_TIME_ELAPSED);
+		ring_buffer.end_frame();
+
+		GLuint64 elapsed_ns = 0;
+		glGetQueryObjectui64v(query, GL_QUERY_RESULT, &elapsed_ns);
+		gpu_ms += (double)elapsed_ns / 1e6;
+	  }
+
+	  const size_t vertex_memory = mesh_arena.get_vertex_arena().get_used_count() * get_vertex_size(format);
+	  const size_t index_memory = mesh_arena.get_index_arena().get_used_count() * sizeof(uint16_t);
+	  std::cout << get_format_name(format) << " (" << get_vertex_size(format) << " bytes per vertex): "
+				<< vertex_memory / 1024 << " KB of vertices, " << index_memory / 1024 << " KB of indices, "
+				<< gpu_ms / frame_count << " ms per frame on the GPU\n";
+	}
+
+	glDeleteQueries(1, &query);
+	glBindFramebuffer(GL_FRAMEBUFFER, 0);
+	glDeleteFramebuffers(1, &framebuffer);
+	glDeleteRenderbuffers(1, &color_buffer);
+	glDeleteRenderbuffers(1, &depth_buffer);
+  }
+
+  destroy_offscreen_context(window);
+  return 0;
+}
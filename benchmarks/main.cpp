@@ -0,0 +1,36 @@
+//
+// Created by tor on 10/19/26.
+//
+
+#include <functional>
+#include <iostream>
+#include <map>
+#include "Benchmark.h"
+
+int main(int argc, char **argv) {
+  static const std::map<std::string, std::function<int(const std::vector<std::string> &)>> benchmarks{
+	  {"clip-grouping", run_clip_grouping_benchmark},
+	  {"pose-cache", run_pose_cache_benchmark},
+	  {"baked-palettes", run_baked_palettes_benchmark},
+	  {"ring-buffer", run_ring_buffer_benchmark},
+	  {"compute-skinning", run_compute_skinning_benchmark},
+	  {"cpu-skinning", run_cpu_skinning_benchmark},
+	  {"vertex-format", run_vertex_format_benchmark},
+	  {"mesh-optimizer", run_mesh_optimizer_benchmark},
+	  {"dual-quaternion", run_dual_quaternion_benchmark},
+	  {"palette-delta", run_palette_delta_benchmark},
+	  {"static-pose", run_static_pose_benchmark},
+  };
+
+  std::vector<std::string> args(argv + 1, argv + argc);
+  auto benchmark = args.empty() ? benchmarks.end() : benchmarks.find(args[0]);
+  if (benchmark == benchmarks.end()) {
+	std::cerr << "Usage: " << argv[0] << " <benchmark> [options]\nAvailable benchmarks:\n";
+	for (const auto &[name, function] : benchmarks) {
+	  std::cerr << "  " << name << "\n";
+	}
+	return 1;
+  }
+
+  return benchmark->second(std::vector<std::string>(args.begin() + 1, args.end()));
+}
@@ -0,0 +1,223 @@
+#version 450 core
+
+layout (location = 0) in vec3 pos;
+layout (location = 1) in vec2 tex;
+layout (location = 2) in ivec4 boneIds;
+layout (location = 3) in vec4 boneWeights;
+// Indices into the per-instance (x) & per-mesh (y) data, unlike gl_InstanceID they include the draw's base instance
+layout (location = 4) in uvec2 drawIndices;
+
+const int MAX_BONE_INFLUENCE = 4;
+
+// The number of influences every vertex of the mesh may have, injected by the renderer. Below 4 the mesh guarantees
+// that the influences come first, that unused ones weigh 0 & that every bone id is valid (see Mesh::influence_count)
+#ifndef MAX_INFLUENCES
+#define MAX_INFLUENCES 4
+#endif
+
+struct InstanceData {
+    mat4 model;
+    // Index of the instance's palette, or of its clip when reading an animation texture
+    uint palette_offset;
+    // Added to the animation texture's playback time (in seconds), unused otherwise
+    float time_offset;
+};
+
+// Positions may be quantized to the mesh's bounding box, this turns them back into model space
+struct MeshData {
+    vec3 position_scale;
+    // Added to gl_VertexID to get the vertex's index within the clip's frames in the vertex animation texture
+    int vertex_animation_offset;
+    vec3 position_offset;
+    // Index of the mesh's local palette within the instance's palette, the bone ids index into the local palette
+    uint palette_offset;
+};
+
+#ifdef DUAL_QUATERNION_SKINNING
+// A rigid bone transform, real.xyz & dual.xyz are the vector parts
+struct DualQuaternion {
+    vec4 real;
+    vec4 dual;
+};
+
+// The palettes of every instance in the batch, one after another
+layout (std430, binding = 0) readonly buffer SkinningDualQuaternions {
+    DualQuaternion skinning_dual_quaternions[];
+};
+#elif defined(ANIMATION_TEXTURE)
+// Every row is a frame of a clip, with the top 3 rows of each skinning matrix of the model's draw palette in 3
+// consecutive texels
+layout (binding = 1) uniform sampler2D animation_texture;
+
+struct AnimationClip {
+    // The texture row of the clip's first frame
+    uint first_frame;
+    uint frame_count;
+    float frames_per_second;
+    // In seconds
+    float duration;
+};
+
+layout (std430, binding = 6) readonly buffer AnimationClips {
+    float animation_time;
+    uint padding[3];
+    AnimationClip clips[];
+};
+#elif defined(VERTEX_ANIMATION_TEXTURE)
+// The skinned position of every vertex in every frame, one frame after another, in rows of 4096 texels
+layout (binding = 2) uniform sampler2D vertex_animation_texture;
+
+struct VertexAnimationClip {
+    // The index of the clip's first texel
+    uint first_texel;
+    uint vertex_count;
+    uint frame_count;
+    float frames_per_second;
+    // In seconds
+    float duration;
+};
+
+layout (std430, binding = 7) readonly buffer VertexAnimationClips {
+    float vertex_animation_time;
+    uint vertex_animation_padding[3];
+    VertexAnimationClip vertex_animation_clips[];
+};
+#else
+// The palettes of every instance in the batch, one after another
+layout (std430, binding = 0) readonly buffer SkinningMatrices {
+    mat4 skinning_matrices[];
+};
+#endif
+
+layout (std430, binding = 1) readonly buffer Instances {
+    InstanceData instances[];
+};
+
+layout (std430, binding = 5) readonly buffer Meshes {
+    MeshData meshes[];
+};
+
+uniform mat4 projection;
+uniform mat4 view;
+
+out vec2 TexCoords;
+
+#ifdef DUAL_QUATERNION_SKINNING
+// Blends the vertex's bone transforms & applies the result to the position
+vec4 skin_dual_quaternion(uint paletteOffset, vec3 position) {
+    vec4 real = vec4(0.0);
+    vec4 dual = vec4(0.0);
+    for (int i = 0; i < MAX_INFLUENCES; i++) {
+#if MAX_INFLUENCES == 4
+        if (boneIds[i] == -1) {
+            continue;
+        }
+#endif
+        DualQuaternion bone = skinning_dual_quaternions[paletteOffset + boneIds[i]];
+        // q & -q are the same rotation, so every bone is blended in the hemisphere of the ones before it
+        float weight = dot(real, bone.real) < 0.0 ? -boneWeights[i] : boneWeights[i];
+        real += bone.real * weight;
+        dual += bone.dual * weight;
+    }
+
+    // Vertices without any influence keep their bind pose position
+    float realLength = max(length(real), 1e-8);
+    real /= realLength;
+    dual /= realLength;
+    vec3 rotated = position + 2.0 * cross(real.xyz, cross(real.xyz, position) + real.w * position);
+    return vec4(rotated + 2.0 * (real.w * dual.xyz - dual.w * real.xyz + cross(real.xyz, dual.xyz)), 1.0);
+}
+#endif
+
+#if defined(ANIMATION_TEXTURE) || defined(VERTEX_ANIMATION_TEXTURE)
+// The two frames of the clip surrounding the instance's time & how far it is between them
+uint firstFrame;
+uint secondFrame;
+float frameFactor;
+
+// Picks the frames like BakedPalettes::sample, the last frame blends towards the first over the rest of the clip
+void select_frames(float time, uint frameCount, float framesPerSecond, float duration) {
+    duration = max(duration, 1e-6);
+    time = mod(time, duration);
+    uint first = min(uint(time * framesPerSecond), frameCount - 1u);
+    float firstTime = float(first) / framesPerSecond;
+    float secondTime = first + 1u == frameCount ? duration : float(first + 1u) / framesPerSecond;
+
+    firstFrame = first;
+    secondFrame = (first + 1u) % frameCount;
+    frameFactor = clamp((time - firstTime) / (secondTime - firstTime), 0.0, 1.0);
+}
+#endif
+
+#ifdef ANIMATION_TEXTURE
+mat4 fetch_skinning_matrix(uint frame, int entry) {
+    vec4 row0 = texelFetch(animation_texture, ivec2(entry * 3, frame), 0);
+    vec4 row1 = texelFetch(animation_texture, ivec2(entry * 3 + 1, frame), 0);
+    vec4 row2 = texelFetch(animation_texture, ivec2(entry * 3 + 2, frame), 0);
+    return transpose(mat4(row0, row1, row2, vec4(0.0, 0.0, 0.0, 1.0)));
+}
+#elif defined(VERTEX_ANIMATION_TEXTURE)
+vec3 fetch_vertex_position(VertexAnimationClip clip, uint frame, int vertex) {
+    uint texel = clip.first_texel + frame * clip.vertex_count + uint(vertex);
+    return texelFetch(vertex_animation_texture, ivec2(texel % 4096u, texel / 4096u), 0).xyz;
+}
+#endif
+
+#if !defined(DUAL_QUATERNION_SKINNING) && !defined(VERTEX_ANIMATION_TEXTURE)
+mat4 get_skinning_matrix(uint paletteOffset, int boneId) {
+#ifdef ANIMATION_TEXTURE
+    int entry = int(paletteOffset) + boneId;
+    return fetch_skinning_matrix(firstFrame, entry) * (1.0 - frameFactor)
+        + fetch_skinning_matrix(secondFrame, entry) * frameFactor;
+#else
+    return skinning_matrices[paletteOffset + boneId];
+#endif
+}
+#endif
+
+void main() {
+    InstanceData instance = instances[drawIndices.x];
+    MeshData mesh = meshes[drawIndices.y];
+    vec3 position = mesh.position_offset + mesh.position_scale * pos;
+    vec4 totalPosition = vec4(0.0f);
+#ifdef ANIMATION_TEXTURE
+    // Every clip's frames hold the model's whole palette, the instance's palette offset selects its clip instead
+    uint paletteOffset = mesh.palette_offset;
+    AnimationClip clip = clips[instance.palette_offset];
+    select_frames(animation_time + instance.time_offset, clip.frame_count, clip.frames_per_second, clip.duration);
+    firstFrame += clip.first_frame;
+    secondFrame += clip.first_frame;
+#else
+    uint paletteOffset = instance.palette_offset + mesh.palette_offset;
+#endif
+
+#ifdef VERTEX_ANIMATION_TEXTURE
+    // The positions are already skinned, so the bones are not needed at all
+    VertexAnimationClip clip = vertex_animation_clips[instance.palette_offset];
+    select_frames(vertex_animation_time + instance.time_offset, clip.frame_count, clip.frames_per_second,
+                  clip.duration);
+    int vertex = gl_VertexID + mesh.vertex_animation_offset;
+    totalPosition = vec4(mix(fetch_vertex_position(clip, firstFrame, vertex),
+                             fetch_vertex_position(clip, secondFrame, vertex), frameFactor), 1.0);
+#elif defined(DUAL_QUATERNION_SKINNING)
+    totalPosition = skin_dual_quaternion(paletteOffset, position);
+#elif MAX_INFLUENCES < 4
+    // No influence has to be checked, & the weighted matrices are summed so that the position is transformed once
+    mat4 skinningMatrix = get_skinning_matrix(paletteOffset, boneIds[0]) * boneWeights[0];
+    for (int i = 1; i < MAX_INFLUENCES; i++) {
+        skinningMatrix += get_skinning_matrix(paletteOffset, boneIds[i]) * boneWeights[i];
+    }
+    totalPosition = skinningMatrix * vec4(position, 1.0);
+#else
+    for (int i = 0; i < MAX_BONE_INFLUENCE; i++) {
+        if (boneIds[i] == -1) {
+            continue;
+        }
+        vec4 localPosition = get_skinning_matrix(paletteOffset, boneIds[i]) * vec4(position, 1.0);
+        totalPosition += localPosition * boneWeights[i];
+    }
+#endif
+
+    gl_Position = projection * view * instance.model * totalPosition;
+    TexCoords = tex;
+}
@@ -0,0 +1,112 @@
+#version 450 core
+
+// One invocation per vertex, the y & z work groups select the job (one mesh of one instance). The jobs are folded
+// into z because a single dimension only guarantees 65535 work groups.
+layout (local_size_x = 64) in;
+
+const int MAX_BONE_INFLUENCE = 4;
+// AnimatedVertex is 13 tightly packed 32 bit values: pos (3), tex_coords (2), bone_ids (4), bone_weights (4)
+const uint VERTEX_STRIDE = 13;
+// PackedAnimatedVertex is 5 32 bit values: pos.xy (unorm16), pos.z (unorm16) & padding, tex_coords (half2),
+// bone_ids (4 x uint8), bone_weights (unorm8 x 4)
+const uint PACKED_VERTEX_STRIDE = 5;
+// A skinned vertex is a world space position (3) followed by its tex_coords (2)
+const uint SKINNED_VERTEX_STRIDE = 5;
+
+struct SkinningJob {
+    mat4 model;
+    // Turns the source positions back into model space, the identity unless they are quantized
+    vec4 position_scale;
+    vec4 position_offset;
+    // First vertex of the mesh in the mesh arena's vertex buffer
+    uint source_vertex;
+    uint vertex_count;
+    // Index of the mesh's local palette, which the bone ids index into
+    uint palette_offset;
+    // Where the skinned vertices of this job are written
+    uint output_vertex;
+};
+
+layout (std430, binding = 0) readonly buffer SkinningMatrices {
+    mat4 skinning_matrices[];
+};
+
+layout (std430, binding = 2) readonly buffer SourceVertices {
+    uint source_vertices[];
+};
+
+layout (std430, binding = 3) readonly buffer Jobs {
+    SkinningJob jobs[];
+};
+
+layout (std430, binding = 4) writeonly buffer SkinnedVertices {
+    float skinned_vertices[];
+};
+
+// Whether the source vertices are PackedAnimatedVertex rather than AnimatedVertex
+uniform bool packed_vertices;
+// The number of jobs in the jobs buffer
+uniform int job_count;
+
+struct SourceVertex {
+    vec3 pos;
+    vec2 tex;
+    ivec4 boneIds;
+    vec4 boneWeights;
+};
+
+SourceVertex read_vertex(uint index) {
+    SourceVertex vertex;
+    if (packed_vertices) {
+        uint source = index * PACKED_VERTEX_STRIDE;
+        vertex.pos = vec3(unpackUnorm2x16(source_vertices[source]), unpackUnorm2x16(source_vertices[source + 1]).x);
+        vertex.tex = unpackHalf2x16(source_vertices[source + 2]);
+        uint boneIds = source_vertices[source + 3];
+        vertex.boneIds = ivec4(boneIds & 0xFFu, (boneIds >> 8) & 0xFFu, (boneIds >> 16) & 0xFFu, boneIds >> 24);
+        vertex.boneWeights = unpackUnorm4x8(source_vertices[source + 4]);
+    } else {
+        uint source = index * VERTEX_STRIDE;
+        vertex.pos = uintBitsToFloat(uvec3(source_vertices[source], source_vertices[source + 1],
+                                           source_vertices[source + 2]));
+        vertex.tex = uintBitsToFloat(uvec2(source_vertices[source + 3], source_vertices[source + 4]));
+        for (int i = 0; i < MAX_BONE_INFLUENCE; i++) {
+            vertex.boneIds[i] = int(source_vertices[source + 5 + i]);
+            vertex.boneWeights[i] = uintBitsToFloat(source_vertices[source + 9 + i]);
+        }
+    }
+    return vertex;
+}
+
+void main() {
+    uint jobIndex = gl_WorkGroupID.z * gl_NumWorkGroups.y + gl_WorkGroupID.y;
+    // The last row of z work groups may be partly empty
+    if (jobIndex >= uint(job_count)) {
+        return;
+    }
+    SkinningJob job = jobs[jobIndex];
+    uint vertex = gl_GlobalInvocationID.x;
+    if (vertex >= job.vertex_count) {
+        return;
+    }
+
+    SourceVertex source = read_vertex(job.source_vertex + vertex);
+    vec3 pos = job.position_offset.xyz + job.position_scale.xyz * source.pos;
+    vec2 tex = source.tex;
+
+    vec4 totalPosition = vec4(0.0f);
+    for (int i = 0; i < MAX_BONE_INFLUENCE; i++) {
+        if (source.boneIds[i] == -1) {
+            continue;
+        }
+        vec4 localPosition = skinning_matrices[job.palette_offset + source.boneIds[i]] * vec4(pos, 1.0);
+        totalPosition += localPosition * source.boneWeights[i];
+    }
+    vec4 worldPosition = job.model * totalPosition;
+
+    uint destination = (job.output_vertex + vertex) * SKINNED_VERTEX_STRIDE;
+    skinned_vertices[destination] = worldPosition.x;
+    skinned_vertices[destination + 1] = worldPosition.y;
+    skinned_vertices[destination + 2] = worldPosition.z;
+    skinned_vertices[destination + 3] = tex.x;
+    skinned_vertices[destination + 4] = tex.y;
+}
@@ -0,0 +1,15 @@
+#version 450 core
+
+// Vertices that are already in world space, e.g. the output of skinning.comp.glsl
+layout (location = 0) in vec3 pos;
+layout (location = 1) in vec2 tex;
+
+uniform mat4 projection;
+uniform mat4 view;
+
+out vec2 TexCoords;
+
+void main() {
+    gl_Position = projection * view * vec4(pos, 1.0);
+    TexCoords = tex;
+}
@@ -2,6 +2,8 @@
 // Created by tor on 3/23/23.
 //
 
+#include <algorithm>
+#include <string>
 #include "Program.h"
 #include "TextureLoader.h"
 
@@ -20,7 +22,8 @@ void Program::run() const {
   configure_opengl();
 
   // Creates a basic camera
-  glm::mat4 view_matrix = glm::lookAt(glm::vec3{3.0f, 6.0f, 5.0f}, {0.0f, 0.0f, 0.0f}, {0.0f, 1.0f, 0.0f});
+  glm::vec3 camera_position{3.0f, 6.0f, 5.0f};
+  glm::mat4 view_matrix = glm::lookAt(camera_position, {0.0f, 0.0f, 0.0f}, {0.0f, 1.0f, 0.0f});
   glm::mat4
 	  projection_matrix = glm::perspective(glm::radians(45.0f), (float)SCR_WIDTH / (float)SCR_HEIGHT, 0.1f, 100.0f);
 
@@ -31,19 +34,27 @@ void Program::run() const {
   shader.setMat4("view", view_matrix);
   shader.setMat4("model", glm::translate(glm::mat4(1.0f), glm::vec3(0.0f)));
 
-  // Setup the skeletal animation shader
-  Shader skeletal_animation_shader = Shader("../shaders/skeletal_animation.vert.glsl", "../shaders/textured.frag.glsl");
-  skeletal_animation_shader.use();
-  glm::mat4 animation_model_matrix = glm::translate(glm::mat4(1.0f), glm::vec3(0.0f));
-  animation_model_matrix = glm::scale(animation_model_matrix, glm::vec3(0.01f, 0.01f, 0.01f));
-  skeletal_animation_shader.setMat4("projection", projection_matrix);
-  skeletal_animation_shader.setMat4("view", view_matrix);
-  skeletal_animation_shader.setMat4("model", animation_model_matrix);
+  // Setup the skeletal animation shader variants, every character's model matrix is read from the per-instance data
+  ShaderPermutations skinning_shaders{"../shaders/skeletal_animation_instanced.vert.glsl",
+									  "../shaders/textured.frag.glsl"};
+  for (auto influence_count : SKINNING_INFLUENCE_COUNTS) {
+	Shader &skinning_shader = skinning_shaders.get(Renderer::get_skinning_defines(influence_count, SKINNING_MODE));
+	skinning_shader.use();
+	skinning_shader.setMat4("projection", projection_matrix);
+	skinning_shader.setMat4("view", view_matrix);
+  }
+
+  // Draws the output of the compute skinning pass & the baked static poses
+  Shader static_mesh_shader = Shader("../shaders/static_mesh.vert.glsl", "../shaders/textured.frag.glsl");
+  static_mesh_shader.use();
+  static_mesh_shader.setMat4("projection", projection_matrix);
+  static_mesh_shader.setMat4("view", view_matrix);
 
   Grid grid{};
 
-  std::optional<Model>
-	  character_model_opt = AnimatedModelLoader::load_model("../assets/character.fbx", "../assets/run.fbx");
+  const std::string character_path = "../assets/character.fbx";
+  const std::string animation_path = "../assets/run.fbx";
+  std::optional<Model> character_model_opt = AnimatedModelLoader::load_model(character_path, animation_path);
   if (!character_model_opt) {
 	std::cerr << "Could not load character model, exiting\n";
 	return;
@@ -55,16 +66,108 @@ void Program::run() const {
 	return;
   }
   auto character_model = *character_model_opt;
+  // Every skinned mesh is packed into the same buffers, so that all characters can share draw calls
+  MeshArena mesh_arena{VERTEX_FORMAT};
+  mesh_arena.add_model(character_model);
+  std::optional<ComputeSkinner> compute_skinner;
+  if (COMPUTE_SKINNING) {
+	compute_skinner.emplace(mesh_arena, "../shaders/skinning.comp.glsl");
+  }
+  // The run cycle is short, so its palettes can be baked at load time and blended at runtime
+  if (SAMPLING_MODE != SamplingMode::KEYFRAMES) {
+	character_model.bake_palettes(BAKED_PALETTE_RATE, SAMPLING_MODE);
+	std::cout << "Baked " << character_model.baked_palettes->frame_count << " palettes of "
+			  << character_model.baked_palettes->bone_count << " bones ("
+			  << character_model.baked_palettes->get_memory_usage() / 1024 << " KB)\n";
+  }
+  // Distant characters freeze the bones that barely move any vertices (fingers, twist bones, ...)
+  character_model.bone_lod_levels.push_back(BoneLod::generate_from_influence(character_model, 0.005f));
+  character_model.bone_lod_levels.push_back(BoneLod::generate_from_influence(character_model, 0.02f));
+  // The whole crowd is animated by the vertex shader, which reads the palettes from a texture
+  std::optional<AnimationTexture> animation_texture;
+  if (SKINNING_MODE == SkinningMode::ANIMATION_TEXTURE) {
+	animation_texture.emplace(std::vector<Model *>{&character_model}, BAKED_PALETTE_RATE);
+	std::cout << "Baked an animation texture of " << animation_texture->get_memory_usage() / 1024 << " KB\n";
+  }
+  // The skinned vertices are baked once & cached next to the animation, later runs load them from that file
+  std::optional<VertexAnimationTexture> vertex_animation_texture;
+  if (SKINNING_MODE == SkinningMode::VERTEX_ANIMATION_TEXTURE) {
+	CpuSkinner cpu_skinner{};
+	std::vector<VertexAnimation> vertex_animations;
+	vertex_animations.push_back(VertexAnimationBaker::load_or_bake(character_model, character_path, animation_path,
+																   VERTEX_ANIMATION_RATE, cpu_skinner));
+	vertex_animation_texture.emplace(std::vector<Model *>{&character_model}, vertex_animations);
+	std::cout << "Loaded a vertex animation texture of " << vertex_animation_texture->get_memory_usage() / 1024
+			  << " KB\n";
+  }
+
+  // Places the crowd in a grid centered around the origin, every character shares the same model
+  std::vector<AnimationInstance> instances;
+  instances.reserve(CROWD_ROWS * CROWD_COLUMNS);
+  for (int row = 0; row < CROWD_ROWS; row++) {
+	for (int column = 0; column < CROWD_COLUMNS; column++) {
+	  glm::vec3 position{((float)column - (float)(CROWD_COLUMNS - 1) / 2.0f) * CROWD_SPACING, 0.0f,
+						 ((float)row - (float)(CROWD_ROWS - 1) / 2.0f) * CROWD_SPACING};
+	  glm::mat4 model_matrix = glm::translate(glm::mat4(1.0f), position);
+	  model_matrix = glm::scale(model_matrix, glm::vec3(0.01f, 0.01f, 0.01f));
+
+	  auto &instance = instances.emplace_back(&character_model, model_matrix);
+	  // Offsets the start time so that the crowd does not run in lockstep
+	  instance.animation_time = character_model.advance_time(0.0, 0.37 * (double)instances.size());
+	  // Idle characters hold the pose of their start time
+	  if (IDLE_CHARACTER_INTERVAL > 0 && (int)instances.size() % IDLE_CHARACTER_INTERVAL == 0) {
+		instance.update(0.0);
+		instance.paused = true;
+	  }
+	}
+  }
+  // Every instance's palette & per-instance data, as well as the draw commands, are written straight into a
+  // persistently mapped buffer each frame
+  RingBuffer palette_ring_buffer{Renderer::get_frame_data_size(character_model, instances.size())};
+  PaletteBuffer palette_buffer{};
+  // Idle characters are skinned once & then drawn as static meshes
+  std::optional<StaticPoseCache> static_pose_cache;
+  // The bake blends linearly, so dual quaternion characters would visibly change pose when they are baked
+  if (STATIC_POSE_FRAMES > 0 && !animation_texture && !vertex_animation_texture
+	  && SKINNING_MODE != SkinningMode::DUAL_QUATERNION) {
+	static_pose_cache.emplace(mesh_arena, STATIC_POSE_FRAMES);
+  }
+
+  AnimationScheduler scheduler{ANIMATION_BUDGET_MS};
+  // Characters that cover less of the screen have their pose evaluated less often
+  scheduler.set_update_rate_lod(UpdateRateLod({{0.15f, 1}, {0.08f, 2}, {0.04f, 4}, {0.0f, 8}},
+											  SkippedFrameMode::INTERPOLATE_PALETTES));
+  scheduler.set_bone_lod_thresholds({0.08f, 0.04f});
+  // Characters that are within half a tick of each other share the same pose
+  PoseCache pose_cache{1.0 / ANIMATION_TICK_RATE, POSE_CACHE_MEMORY_CAP};
+  scheduler.set_pose_cache(&pose_cache);
+
+  // Animation is evaluated at a fixed rate, rendering interpolates between the two most recent ticks
+  const double tick_length = 1.0 / ANIMATION_TICK_RATE;
+  double tick_accumulator = 0.0;
 
   double delta_time;
   double last_frame = glfwGetTime();
+  double last_title_update = last_frame;
 
   while (!glfwWindowShouldClose(glfw_window)) {
 	double current_frame = glfwGetTime();
 	delta_time = current_frame - last_frame;
 	last_frame = current_frame;
 
-	character_model.update_skinning_matrix(delta_time);
+	// Drops ticks after a long stall rather than trying to catch up all at once
+	tick_accumulator = std::min(tick_accumulator + delta_time, MAX_TICKS_PER_FRAME * tick_length);
+	// Nothing is animated on the CPU when the poses are read from an animation texture
+	if (!animation_texture && !vertex_animation_texture) {
+	  while (tick_accumulator >= tick_length) {
+		scheduler.update(instances, tick_length, camera_position);
+		tick_accumulator -= tick_length;
+	  }
+	  scheduler.interpolate(instances, tick_accumulator / tick_length);
+	}
+	if (static_pose_cache) {
+	  static_pose_cache->update(instances);
+	}
 
 	// --- Render current frame
 	glClearColor(0.7f, 0.7f, 0.7f, 1.0f);
@@ -73,14 +176,42 @@ void Program::run() const {
 	shader.use();
 	grid.render();
 
-	skeletal_animation_shader.use();
-	// transfer the skinning matrices to the GPU
-	const auto transforms = character_model.skinning_matrices;
-	for (unsigned int i = 0; i < transforms.size(); i++) {
-	  skeletal_animation_shader.setMat4("skinning_matrices[" + std::to_string(i) + "]", transforms[i]);
+	palette_ring_buffer.begin_frame();
+	Renderer::draw_call_count = 0;
+	if (compute_skinner) {
+	  compute_skinner->skin(instances, palette_ring_buffer);
+	  static_mesh_shader.use();
+	  compute_skinner->render(palette_ring_buffer);
+	} else {
+	  if (animation_texture) {
+		animation_texture->bind(current_frame);
+	  }
+	  if (vertex_animation_texture) {
+		vertex_animation_texture->bind(current_frame);
+	  }
+	  Renderer::render_instances(instances, palette_ring_buffer, skinning_shaders, SKINNING_MODE,
+								 DELTA_PALETTE_UPLOAD ? &palette_buffer : nullptr);
 	}
+	if (static_pose_cache) {
+	  static_mesh_shader.use();
+	  static_pose_cache->render(palette_ring_buffer);
+	}
+	palette_ring_buffer.end_frame();
 
-	Renderer::render_model(character_model);
+	// Reports the character draw calls, palette bytes uploaded & baked characters of the last frame once per second
+	if (current_frame - last_title_update >= 1.0) {
+	  std::string title = "Skeletal Animation - " + std::to_string(instances.size()) + " characters, "
+		  + std::to_string(Renderer::draw_call_count) + " draw calls";
+	  if (DELTA_PALETTE_UPLOAD) {
+		title += ", " + std::to_string(palette_buffer.get_uploaded_bytes()) + " of "
+			+ std::to_string(palette_buffer.get_palette_bytes()) + " palette bytes uploaded";
+	  }
+	  if (static_pose_cache) {
+		title += ", " + std::to_string(static_pose_cache->get_baked_instance_count()) + " baked";
+	  }
+	  glfwSetWindowTitle(glfw_window, title.c_str());
+	  last_title_update = current_frame;
+	}
 
 	glfwSwapBuffers(glfw_window);
 	glfwPollEvents();
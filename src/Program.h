@@ -14,7 +14,14 @@
 #include "shader/Shader.h"
 #include "shapes/Grid.h"
 #include "animation/AnimatedModelLoader.h"
+#include "animation/AnimationScheduler.h"
+#include "renderer/AnimationTexture.h"
+#include "renderer/ComputeSkinner.h"
+#include "renderer/PaletteBuffer.h"
+#include "renderer/VertexAnimationTexture.h"
 #include "renderer/Renderer.h"
+#include "renderer/RingBuffer.h"
+#include "renderer/StaticPoseCache.h"
 
 class Program {
  public:
@@ -26,6 +33,42 @@ class Program {
   const int SCR_WIDTH = 800;
   const int SCR_HEIGHT = 800;
 
+  const int CROWD_ROWS = 3;
+  const int CROWD_COLUMNS = 3;
+  const float CROWD_SPACING = 2.0f;
+  // The maximum time (in milliseconds) spent on updating animations each tick
+  const double ANIMATION_BUDGET_MS = 2.0;
+  // How many times per second the animations are evaluated, independent of the display refresh rate
+  const double ANIMATION_TICK_RATE = 30.0;
+  const double MAX_TICKS_PER_FRAME = 4.0;
+  const size_t POSE_CACHE_MEMORY_CAP = 4 * 1024 * 1024;
+  // Frames per second of animation when baking palettes
+  const double BAKED_PALETTE_RATE = 60.0;
+  // How poses are sampled on the CPU. The baked modes skip keyframe sampling & the hierarchy walk, but always evaluate
+  // every bone, which bypasses bone LOD, & leave the pose cache with nothing to save
+  const SamplingMode SAMPLING_MODE = SamplingMode::KEYFRAMES;
+  // Frames per second of animation when baking skinned vertices, distant characters do not need many
+  const double VERTEX_ANIMATION_RATE = 20.0;
+  // Skins the crowd once per frame in a compute pass & draws the result as static geometry, rather than skinning
+  // in the vertex shader
+  const bool COMPUTE_SKINNING = false;
+  // How the meshes are stored on the GPU, PACKED takes less than half the memory & bandwidth
+  const VertexFormat VERTEX_FORMAT = VertexFormat::PACKED;
+  // How the vertex shader blends bones, the compute skinning pass always blends matrices linearly. ANIMATION_TEXTURE
+  // plays the baked clip entirely on the GPU, without any animation updates. VERTEX_ANIMATION_TEXTURE additionally
+  // skips skinning, which only holds up for characters far from the camera
+  const SkinningMode SKINNING_MODE = SkinningMode::LINEAR_BLEND;
+  // Keeps the palettes on the GPU between frames & only uploads the bones that changed, rather than writing every
+  // palette into the ring buffer each frame. The palettes are interpolated every frame, so this only skips the bones
+  // that hold still (frozen by bone LOD, paused characters, ...)
+  const bool DELTA_PALETTE_UPLOAD = false;
+  // Characters whose pose has not changed for this many frames are baked into static meshes & drawn without
+  // skinning until they move again, 0 disables the bake. Only used when the poses are animated on the CPU & blended
+  // linearly
+  const unsigned int STATIC_POSE_FRAMES = StaticPoseCache::DEFAULT_FREEZE_FRAMES;
+  // Every n-th character of the crowd stands idle, 0 keeps everyone running
+  const int IDLE_CHARACTER_INTERVAL = 0;
+
   static void configure_opengl() {
 	glEnable(GL_DEPTH_TEST);
   }
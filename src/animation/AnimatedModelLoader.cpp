@@ -2,6 +2,7 @@
 // Created by tor on 3/23/23.
 //
 
+#include <algorithm>
 #include "AnimatedModelLoader.h"
 
 static const aiScene *setup_scene(const std::string &path) {
@@ -10,6 +11,7 @@ static const aiScene *setup_scene(const std::string &path) {
   aiSetImportPropertyInteger(props, "PP_PTV_NORMALIZE", 1);
   const aiScene *scene = (aiScene *)aiImportFileExWithProperties(path.c_str(),
 																 aiProcess_Triangulate
+																	 | aiProcess_JoinIdenticalVertices
 																	 | aiProcess_GenSmoothNormals
 																	 | aiProcess_ForceGenNormals,
 																 nullptr, props);
@@ -22,7 +24,9 @@ static const aiScene *setup_scene(const std::string &path) {
   return scene;
 }
 
-std::optional<Model> AnimatedModelLoader::load_model(const std::string &model_path, const std::string &animation_path) {
+std::optional<Model> AnimatedModelLoader::load_model(const std::string &model_path,
+													 const std::string &animation_path,
+													 bool optimize_meshes) {
   auto model_scene = setup_scene(model_path);
   auto animation_scene = setup_scene(animation_path);
   if (model_scene == nullptr || animation_scene == nullptr) {
@@ -31,6 +35,14 @@ std::optional<Model> AnimatedModelLoader::load_model(const std::string &model_pa
 
   Model model{};
   load_node(model, model_scene, model_scene->mRootNode);
+  if (optimize_meshes) {
+	for (auto &mesh : model.mesh_list) {
+	  MeshOptimizer::optimize(mesh);
+	}
+  }
+  model.update_palette_offsets();
+  // There is no limit on the number of bones, every bone found in the meshes starts out in bind pose
+  model.skinning_matrices.assign(model.get_bone_count(), glm::mat4(1.0f));
 
   auto animation = animation_scene->mAnimations[1];
   model.ticks_per_second = animation->mTicksPerSecond;
@@ -48,7 +60,10 @@ void AnimatedModelLoader::load_node(Model &model, const aiScene *scene, const ai
 	// The node object only contains indices to index the actual objects in the scene.
 	// The scene contains all the data, node is just to keep stuff organized (like relations between nodes).
 	aiMesh *mesh = scene->mMeshes[node->mMeshes[i]];
-	model.mesh_list.push_back(load_mesh(scene, mesh, model));
+	// Each part is drawn with the skinning shader variant that matches its number of bone influences
+	for (auto &part : MeshOptimizer::split_by_influence_count(load_mesh(scene, mesh, model))) {
+	  model.mesh_list.push_back(std::move(part));
+	}
   }
 
   for (unsigned int i = 0; i < node->mNumChildren; i++) {
@@ -80,6 +95,7 @@ Mesh AnimatedModelLoader::load_mesh(const aiScene *, const aiMesh *mesh, Model &
   for (unsigned int i = 0; i < mesh->mNumVertices; i++) {
 	AnimatedVertex vert{};
 	vert.pos = glm::vec3(mesh->mVertices[i].x, mesh->mVertices[i].y, mesh->mVertices[i].z);
+	model.bounding_radius = std::max(model.bounding_radius, glm::length(vert.pos));
 
 	if (mesh->mTextureCoords[0]) {
 	  vert.tex_coords = glm::vec2(mesh->mTextureCoords[0][i].x, mesh->mTextureCoords[0][i].y);
@@ -98,14 +114,16 @@ Mesh AnimatedModelLoader::load_mesh(const aiScene *, const aiMesh *mesh, Model &
   result.vertices = all_vertices;
   result.indices = all_indices;
 
-  load_vertex_bone_weights(mesh, result.vertices, model);
-  create_mesh(result);
+  load_vertex_bone_weights(mesh, result.vertices, result.bone_palette, model);
+  // Welding has to wait for the bone weights, since they are assigned by the vertex's index in the aiMesh
+  MeshOptimizer::weld_vertices(result);
 
   return result;
 }
 
 void AnimatedModelLoader::load_vertex_bone_weights(const aiMesh *mesh,
 												   std::vector<AnimatedVertex> &vertices,
+												   std::vector<unsigned int> &bone_palette,
 												   Model &model) {
   // NOTE: bone_index refers to a "relative index", that is, it is able to index into mesh->mBones.
   // Which is NOT the same as bone_id, which is a globally unique id given to all bones.
@@ -127,12 +145,15 @@ void AnimatedModelLoader::load_vertex_bone_weights(const aiMesh *mesh,
 	  bone_id = absolute_index->second;
 	}
 
+	// The vertices refer to the bone by its index in the mesh's local palette, which is also its index in mBones
+	bone_palette.push_back((unsigned int)bone_id);
+
 	// Configure the vertex data (weights and which bones impact this vertex)
 	auto weights = mesh->mBones[bone_index]->mWeights;
 	for (unsigned int weight_index = 0; weight_index < mesh->mBones[bone_index]->mNumWeights; weight_index++) {
-	  // vertex_id is the index of the vertex that is influenced by the bone with bone_id
+	  // vertex_id is the index of the vertex that is influenced by the bone with bone_index
 	  auto vertex_id = weights[weight_index].mVertexId;
-	  vertices[vertex_id].set_weight_to_first_unset(bone_id, weights[weight_index].mWeight);
+	  vertices[vertex_id].set_weight_to_first_unset(bone_index, weights[weight_index].mWeight);
 	}
   }
 }
@@ -152,43 +173,3 @@ void AnimatedModelLoader::load_bones(Model &model, const aiAnimation *animation)
 	model.bone_list.emplace_back(model.bone_name_to_index[channel->mNodeName.data], channel);
   }
 }
-
-void AnimatedModelLoader::create_mesh(Mesh &mesh) {
-  glGenVertexArrays(1, &mesh.vao);
-  glGenBuffers(1, &mesh.vbo);
-  glGenBuffers(1, &mesh.ebo);
-
-  glBindVertexArray(mesh.vao);
-  glBindBuffer(GL_ARRAY_BUFFER, mesh.vbo);
-  glBufferData(GL_ARRAY_BUFFER,
-			   (long)(mesh.vertices.size() * sizeof(AnimatedVertex)),
-			   &mesh.vertices[0],
-			   GL_STATIC_DRAW);
-
-  glBindBuffer(GL_ELEMENT_ARRAY_BUFFER, mesh.ebo);
-  glBufferData(GL_ELEMENT_ARRAY_BUFFER,
-			   (long)(mesh.indices.size() * sizeof(unsigned int)),
-			   &mesh.indices[0],
-			   GL_STATIC_DRAW);
-
-  // Vertex Positions
-  glEnableVertexAttribArray(0);
-  glVertexAttribPointer(0, 3, GL_FLOAT, GL_FALSE, sizeof(AnimatedVertex), nullptr);
-
-  // Texture coordinates
-  glEnableVertexAttribArray(1);
-  glVertexAttribPointer(1, 2, GL_FLOAT, GL_FALSE, sizeof(AnimatedVertex),
-						(void *)offsetof(AnimatedVertex, tex_coords));
-
-  // Bone IDs that affect this mesh's vertices
-  glEnableVertexAttribArray(2);
-  glVertexAttribIPointer(2, 4, GL_INT, sizeof(AnimatedVertex),
-						 (void *)offsetof(AnimatedVertex, bone_ids));
-
-  // Bone weights that affect this mesh's vertices
-  glEnableVertexAttribArray(3);
-  glVertexAttribPointer(3, 4, GL_FLOAT, GL_FALSE, sizeof(AnimatedVertex),
-						(void *)offsetof(AnimatedVertex, bone_weights));
-
-  glBindVertexArray(0);
-}
@@ -19,11 +19,18 @@
 
 #include "Model.h"
 #include "Conversions.h"
+#include "MeshOptimizer.h"
 
+// Loads the model's data on the CPU, it has to be added to a MeshArena before it can be rendered
 class AnimatedModelLoader {
  public:
+  /**
+   * @param optimize_meshes Whether to reorder each mesh's triangles & vertices with the MeshOptimizer, this is only
+   * meant to be disabled in order to compare against the original order.
+   */
   [[nodiscard]] static std::optional<Model> load_model(const std::string &model_path,
-													   const std::string &animation_path);
+													   const std::string &animation_path,
+													   bool optimize_meshes = true);
  private:
   static void load_node(Model &model, const aiScene *scene, const aiNode *node);
 
@@ -50,14 +57,17 @@ class AnimatedModelLoader {
 									  const aiMesh *mesh,
 									  Model &model
   );
-  static void load_vertex_bone_weights(const aiMesh *mesh, std::vector<AnimatedVertex> &vertices, Model &model);
+  /**
+   * Assigns the vertices' bone weights & builds the mesh's local palette. New bones are given the next model bone
+   * id, while the vertices refer to bones by their index in the local palette.
+   */
+  static void load_vertex_bone_weights(const aiMesh *mesh,
+									   std::vector<AnimatedVertex> &vertices,
+									   std::vector<unsigned int> &bone_palette,
+									   Model &model);
 
   static void load_bones(Model &model, const aiAnimation *animation);
 
-  /**
-   * Initializes the OpenGL buffers & sends the mesh data to the GPU.
-   */
-  static void create_mesh(Mesh &mesh);
 };
 
 #endif //OPENGL_SKELETAL_ANIMATION_SRC_LOADERS_MODELLOADER_H_
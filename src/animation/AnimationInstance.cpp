@@ -0,0 +1,67 @@
+//
+// Created by tor on 10/19/26.
+//
+
+#include <algorithm>
+#include <utility>
+#include "AnimationInstance.h"
+#include "Palette.h"
+
+AnimationInstance::AnimationInstance(Model *model, const glm::mat4 &model_matrix)
+	: model(model),
+	  model_matrix(model_matrix),
+	  skinning_matrices(model->skinning_matrices),
+	  previous_skinning_matrices(model->skinning_matrices) {}
+
+void AnimationInstance::update(double delta_time, PoseCache *pose_cache) {
+  animation_time = model->advance_time(animation_time, delta_time + pending_delta_time);
+  pending_delta_time = 0.0;
+  frames_since_update = 0;
+
+  std::swap(previous_skinning_matrices, skinning_matrices);
+  if (pose_cache != nullptr) {
+	pose_cache->evaluate(*model, animation_time, bone_lod, skinning_matrices);
+  } else {
+	model->evaluate_pose(animation_time, skinning_matrices, bone_lod);
+  }
+
+  // A still pose (paused clip, held frame, prop, ...) is drawn the same as before, unless it was still blending
+  // towards it
+  const bool was_moving = pose_moving;
+  pose_moving = skinning_matrices != previous_skinning_matrices;
+  if (pose_moving || was_moving) {
+	pose_version++;
+  }
+}
+
+void AnimationInstance::write_render_skinning_matrices(glm::mat4 *out) const {
+  if (render_blend_factor >= 1.0f || !pose_moving) {
+	model->gather_palette(skinning_matrices.data(), out);
+	return;
+  }
+  for (auto bone : model->get_draw_palette()) {
+	blend_palettes(&previous_skinning_matrices[bone], &skinning_matrices[bone], render_blend_factor, out++, 1);
+  }
+}
+
+void AnimationInstance::write_render_dual_quaternions(DualQuaternion *out) const {
+  // Converting one bone at a time avoids a temporary palette
+  for (auto bone : model->get_draw_palette()) {
+	glm::mat4 blended = skinning_matrices[bone];
+	if (render_blend_factor < 1.0f && pose_moving) {
+	  blend_palettes(&previous_skinning_matrices[bone], &skinning_matrices[bone], render_blend_factor, &blended, 1);
+	}
+	*out++ = DualQuaternion::from_matrix(blended);
+  }
+}
+
+float AnimationInstance::get_bounding_radius() const {
+  float scale = std::max({glm::length(glm::vec3(model_matrix[0])),
+						  glm::length(glm::vec3(model_matrix[1])),
+						  glm::length(glm::vec3(model_matrix[2]))});
+  return model->bounding_radius * scale;
+}
+
+float AnimationInstance::get_screen_size(const glm::vec3 &camera_position) const {
+  return get_bounding_radius() / std::max(glm::distance(get_position(), camera_position), 0.01f);
+}
@@ -0,0 +1,75 @@
+//
+// Created by tor on 10/19/26.
+//
+
+#ifndef OPENGL_SKELETAL_ANIMATION_SRC_ANIMATION_ANIMATIONINSTANCE_H_
+#define OPENGL_SKELETAL_ANIMATION_SRC_ANIMATION_ANIMATIONINSTANCE_H_
+
+#include <vector>
+#include <glm/glm.hpp>
+#include "DualQuaternion.h"
+#include "Model.h"
+#include "PoseCache.h"
+
+// A single animated character in the world. The model (meshes, skeleton and animation) is shared between
+// instances, while the playback time and the resulting skinning matrices are owned by the instance.
+struct AnimationInstance {
+  Model *model = nullptr;
+  glm::mat4 model_matrix{1.0f};
+
+  // Scales the scheduling priority of this instance, e.g. to favour the player character over a crowd
+  float importance = 1.0f;
+
+  double animation_time = 0.0;
+  // Time (in seconds) that has passed since the instance was last updated and that has not yet been
+  // applied to animation_time. This is non-zero while the scheduler defers the instance.
+  double pending_delta_time = 0.0;
+
+  // Index of the model's bone LOD level used when evaluating the pose, 0 evaluates every bone
+  unsigned int bone_lod = 0;
+
+  // The pose is evaluated every update_interval animation ticks, see UpdateRateLod
+  unsigned int update_interval = 1;
+  unsigned int frames_since_update = 0;
+
+  // The most recently evaluated skinning matrices, and the ones evaluated before those
+  std::vector<glm::mat4> skinning_matrices{};
+  std::vector<glm::mat4> previous_skinning_matrices{};
+  // How far (0-1) the rendered palette is blended from previous_skinning_matrices towards skinning_matrices
+  float render_blend_factor = 1.0f;
+  // Whether the last two evaluated poses differ. While they do not, render_blend_factor has no effect.
+  bool pose_moving = false;
+  // Incremented whenever update() changes what the instance may be drawn with, i.e. the evaluated pose differs from
+  // the one before it or the one before that. Lets changes be detected without comparing palettes.
+  unsigned int pose_version = 0;
+
+  // Paused instances hold their current pose, the scheduler neither advances nor re-evaluates them
+  bool paused = false;
+  // Set by StaticPoseCache while the instance is drawn from a baked static mesh, the skinned draw paths skip it
+  bool static_pose = false;
+
+  AnimationInstance(Model *model, const glm::mat4 &model_matrix);
+
+  // Advances the animation by delta_time plus any pending time and re-evaluates the skinning matrices.
+  // If a pose cache is given, the skinning matrices are shared with other instances at a similar time.
+  void update(double delta_time, PoseCache *pose_cache = nullptr);
+
+  // Writes the draw palette of this frame (Model::get_palette_size() matrices, see Model::gather_palette) to out,
+  // which may point straight into mapped GPU memory. Blends the last two palettes according to render_blend_factor.
+  void write_render_skinning_matrices(glm::mat4 *out) const;
+
+  // Like write_render_skinning_matrices, but converts every blended skinning matrix to a dual quaternion
+  void write_render_dual_quaternions(DualQuaternion *out) const;
+
+  [[nodiscard]] glm::vec3 get_position() const {
+	return glm::vec3(model_matrix[3]);
+  }
+
+  // Returns the model's bounding radius scaled to world space
+  [[nodiscard]] float get_bounding_radius() const;
+
+  // Approximates how large the instance appears on screen: its bounding radius divided by the camera distance
+  [[nodiscard]] float get_screen_size(const glm::vec3 &camera_position) const;
+};
+
+#endif //OPENGL_SKELETAL_ANIMATION_SRC_ANIMATION_ANIMATIONINSTANCE_H_
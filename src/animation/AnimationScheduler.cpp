@@ -0,0 +1,117 @@
+//
+// Created by tor on 10/19/26.
+//
+
+#include <algorithm>
+#include <chrono>
+#include <functional>
+#include "AnimationScheduler.h"
+
+void AnimationScheduler::update(std::vector<AnimationInstance> &instances,
+								double delta_time,
+								const glm::vec3 &camera_position) {
+  const auto start = std::chrono::steady_clock::now();
+  stats = {};
+
+  update_order.clear();
+  for (unsigned int i = 0; i < instances.size(); i++) {
+	auto &instance = instances[i];
+	if (instance.paused) {
+	  stats.skipped++;
+	  continue;
+	}
+	instance.pending_delta_time += delta_time;
+	instance.frames_since_update++;
+
+	float screen_size = instance.get_screen_size(camera_position);
+	instance.update_interval = update_rate_lod.select_update_interval(screen_size);
+	instance.bone_lod = select_bone_lod(instance, screen_size);
+	if (instance.frames_since_update < instance.update_interval) {
+	  stats.skipped++;
+	  continue;
+	}
+	update_order.emplace_back(compute_priority(instance, screen_size), i);
+  }
+  std::sort(update_order.begin(), update_order.end(), [](const auto &a, const auto &b) {
+	return a.first > b.first;
+  });
+
+  if (group_by_clip) {
+	group_update_order(instances);
+  }
+  const auto update_start = std::chrono::steady_clock::now();
+  for (unsigned int i = 0; i < update_order.size(); i++) {
+	std::chrono::duration<double, std::milli> elapsed = std::chrono::steady_clock::now() - start;
+	// At least one instance is always updated so that the animations progress even with a tiny budget
+	if (stats.updated > 0 && elapsed.count() >= frame_budget_ms) {
+	  break;
+	}
+
+	// The pending time already contains this tick's delta time
+	instances[update_order[i].second].update(0.0, pose_cache);
+	stats.updated++;
+  }
+
+  if (stats.updated > 0) {
+	std::chrono::duration<double, std::milli> update_time = std::chrono::steady_clock::now() - update_start;
+	double cost = update_time.count() / stats.updated;
+	average_update_ms = average_update_ms > 0.0 ? 0.9 * average_update_ms + 0.1 * cost : cost;
+  }
+
+  stats.deferred = (unsigned int)update_order.size() - stats.updated;
+  for (const auto &instance : instances) {
+	stats.max_pending_time = std::max(stats.max_pending_time, instance.pending_delta_time);
+  }
+  stats.elapsed_ms = std::chrono::duration<double, std::milli>(std::chrono::steady_clock::now() - start).count();
+}
+
+void AnimationScheduler::interpolate(std::vector<AnimationInstance> &instances, double tick_alpha) const {
+  bool interpolate_skipped = update_rate_lod.get_skipped_frame_mode() == SkippedFrameMode::INTERPOLATE_PALETTES;
+
+  for (auto &instance : instances) {
+	// A paused pose is drawn as is, so that its palette stays the same from frame to frame
+	if (instance.paused || (instance.update_interval > 1 && !interpolate_skipped)) {
+	  instance.render_blend_factor = 1.0f;
+	  continue;
+	}
+
+	// Ticks that were skipped by the update-rate LOD count as part of the interval being interpolated over
+	auto factor = (float)(((double)instance.frames_since_update + tick_alpha) / (double)instance.update_interval);
+	instance.render_blend_factor = std::min(factor, 1.0f);
+  }
+}
+
+void AnimationScheduler::group_update_order(const std::vector<AnimationInstance> &instances) {
+  auto count = (unsigned int)update_order.size();
+  // Every instance was skipped (LOD or paused), clamping to an empty range would be undefined
+  if (count == 0) {
+	return;
+  }
+  if (average_update_ms > 0.0) {
+	count = (unsigned int)std::clamp(frame_budget_ms / average_update_ms, 1.0, (double)count);
+  }
+
+  // Within a clip, instances are also sorted by LOD and time so that neighbours sample the same keyframes
+  std::sort(update_order.begin(), update_order.begin() + count, [&](const auto &a, const auto &b) {
+	const auto &first = instances[a.second];
+	const auto &second = instances[b.second];
+	if (first.model != second.model) {
+	  return std::less<const Model *>()(first.model, second.model);
+	}
+	if (first.bone_lod != second.bone_lod) {
+	  return first.bone_lod < second.bone_lod;
+	}
+	return first.animation_time < second.animation_time;
+  });
+}
+
+unsigned int AnimationScheduler::select_bone_lod(const AnimationInstance &instance, float screen_size) const {
+  auto level = (unsigned int)std::count_if(bone_lod_thresholds.begin(),
+										   bone_lod_thresholds.end(),
+										   [&](float threshold) { return screen_size < threshold; });
+  return std::min(level, (unsigned int)instance.model->bone_lod_levels.size());
+}
+
+double AnimationScheduler::compute_priority(const AnimationInstance &instance, float screen_size) {
+  return (double)screen_size * instance.importance * (1.0 + instance.pending_delta_time * STARVATION_WEIGHT);
+}
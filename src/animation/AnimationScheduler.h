@@ -0,0 +1,101 @@
+//
+// Created by tor on 10/19/26.
+//
+
+#ifndef OPENGL_SKELETAL_ANIMATION_SRC_ANIMATION_ANIMATIONSCHEDULER_H_
+#define OPENGL_SKELETAL_ANIMATION_SRC_ANIMATION_ANIMATIONSCHEDULER_H_
+
+#include <utility>
+#include <vector>
+#include <glm/glm.hpp>
+#include "AnimationInstance.h"
+#include "UpdateRateLod.h"
+
+struct SchedulerStats {
+  unsigned int updated = 0;
+  unsigned int deferred = 0;
+  // Instances that were not due for an update this tick because of their update-rate LOD tier
+  unsigned int skipped = 0;
+  // Wall-clock time spent updating instances during the most recent tick
+  double elapsed_ms = 0.0;
+  // The longest time any instance is currently lagging behind because it was deferred
+  double max_pending_time = 0.0;
+};
+
+// Updates animation instances in priority order until the per-tick time budget is used up.
+// Instances that do not fit in the budget are deferred to a later tick, their delta time is accumulated in
+// AnimationInstance::pending_delta_time so that they still end up at the correct animation time.
+// Optionally, an update-rate LOD lowers how often small or distant instances are considered at all.
+class AnimationScheduler {
+ public:
+  explicit AnimationScheduler(double frame_budget_ms) : frame_budget_ms(frame_budget_ms) {}
+
+  // Runs one animation tick of delta_time seconds
+  void update(std::vector<AnimationInstance> &instances, double delta_time, const glm::vec3 &camera_position);
+
+  /**
+   * Sets how much each instance's last two evaluated palettes are blended when it is drawn this frame.
+   * This lets animation tick at a lower, fixed rate than the display refresh rate.
+   * @param tick_alpha How far (0-1) the render time is between the most recent tick and the next one.
+   */
+  void interpolate(std::vector<AnimationInstance> &instances, double tick_alpha) const;
+
+  [[nodiscard]] const SchedulerStats &get_stats() const {
+	return stats;
+  }
+
+  void set_frame_budget(double budget_ms) {
+	frame_budget_ms = budget_ms;
+  }
+
+  void set_update_rate_lod(UpdateRateLod lod) {
+	update_rate_lod = std::move(lod);
+  }
+
+  // An instance uses bone LOD level n when its screen size is below n of the thresholds. The level is
+  // clamped to the number of levels its model defines.
+  void set_bone_lod_thresholds(std::vector<float> min_screen_sizes) {
+	bone_lod_thresholds = std::move(min_screen_sizes);
+  }
+
+  // When enabled, the instances picked for an update are evaluated grouped by model (i.e. skeleton & clip)
+  // so that each clip's keyframes stay in the CPU caches while all of its instances are updated.
+  void set_group_by_clip(bool group) {
+	group_by_clip = group;
+  }
+
+  // Instances are evaluated through the given cache, or directly if it is nullptr. The cache is not owned.
+  void set_pose_cache(PoseCache *cache) {
+	pose_cache = cache;
+  }
+
+ private:
+  // Deferred instances gain priority the longer they wait, this is how fast (per second of pending time).
+  // Without it, small & distant instances could be starved forever when the budget is tight.
+  static constexpr double STARVATION_WEIGHT = 10.0;
+
+  double frame_budget_ms;
+  UpdateRateLod update_rate_lod{};
+  std::vector<float> bone_lod_thresholds{};
+  bool group_by_clip = true;
+  PoseCache *pose_cache = nullptr;
+  // Moving average of how long a single instance update takes, used to pick how many instances fit in the
+  // budget before they are reordered by clip
+  double average_update_ms = 0.0;
+  SchedulerStats stats{};
+  // (priority, instance index) pairs, kept around to avoid reallocating every tick
+  std::vector<std::pair<double, unsigned int>> update_order{};
+
+  // Higher is more important. Based on the approximate screen size of the instance (bounding radius divided by
+  // the distance to the camera), its importance and how long it has been deferred.
+  [[nodiscard]] static double compute_priority(const AnimationInstance &instance, float screen_size);
+
+  [[nodiscard]] unsigned int select_bone_lod(const AnimationInstance &instance, float screen_size) const;
+
+  // Reorders the instances that are estimated to fit in the budget so that instances sharing a clip are
+  // adjacent. The estimate only decides what gets grouped, the instances after it keep their priority order and
+  // are still updated while the budget's deadline has not passed.
+  void group_update_order(const std::vector<AnimationInstance> &instances);
+};
+
+#endif //OPENGL_SKELETAL_ANIMATION_SRC_ANIMATION_ANIMATIONSCHEDULER_H_
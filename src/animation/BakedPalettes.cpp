@@ -0,0 +1,33 @@
+//
+// Created by tor on 10/19/26.
+//
+
+#include <algorithm>
+#include <cmath>
+#include "BakedPalettes.h"
+#include "Palette.h"
+
+void BakedPalettes::sample(double animation_time,
+						   bool interpolate,
+						   std::vector<glm::mat4> &out_skinning_matrices) const {
+  double frame = animation_time / frame_length;
+
+  if (!interpolate) {
+	auto nearest = (unsigned int)std::llround(frame) % frame_count;
+	std::copy_n(skinning_matrices.begin() + (long)(nearest * bone_count), bone_count, out_skinning_matrices.begin());
+	return;
+  }
+
+  auto first = std::min((unsigned int)frame, frame_count - 1);
+  auto second = (first + 1) % frame_count;
+  // The last frame blends towards the first one over whatever remains of the clip
+  double first_time = first * frame_length;
+  double second_time = first + 1 == frame_count ? animation_duration : first_time + frame_length;
+  auto factor = (float)std::clamp((animation_time - first_time) / (second_time - first_time), 0.0, 1.0);
+
+  blend_palettes(&skinning_matrices[first * bone_count],
+				 &skinning_matrices[second * bone_count],
+				 factor,
+				 out_skinning_matrices.data(),
+				 bone_count);
+}
@@ -0,0 +1,39 @@
+//
+// Created by tor on 10/19/26.
+//
+
+#ifndef OPENGL_SKELETAL_ANIMATION_SRC_ANIMATION_BAKEDPALETTES_H_
+#define OPENGL_SKELETAL_ANIMATION_SRC_ANIMATION_BAKEDPALETTES_H_
+
+#include <vector>
+#include <glm/glm.hpp>
+
+// How a model turns an animation time into skinning matrices
+enum class SamplingMode {
+  // Samples each bone's keyframes and walks the hierarchy (the default)
+  KEYFRAMES,
+  // Picks the closest of the pre-baked palettes
+  BAKED_NEAREST,
+  // Blends the two pre-baked palettes surrounding the animation time
+  BAKED_INTERPOLATED
+};
+
+// The skinning matrices of a whole clip, evaluated at a fixed rate when the model is loaded. Trades memory for
+// not having to search keyframes, build TRS matrices or walk the hierarchy at runtime.
+struct BakedPalettes {
+  // Time between two frames, in animation ticks
+  double frame_length = 0.0;
+  double animation_duration = 0.0;
+  unsigned int frame_count = 0;
+  unsigned int bone_count = 0;
+  // frame_count palettes of bone_count matrices each, stored one frame after another
+  std::vector<glm::mat4> skinning_matrices{};
+
+  void sample(double animation_time, bool interpolate, std::vector<glm::mat4> &out_skinning_matrices) const;
+
+  [[nodiscard]] size_t get_memory_usage() const {
+	return skinning_matrices.size() * sizeof(glm::mat4);
+  }
+};
+
+#endif //OPENGL_SKELETAL_ANIMATION_SRC_ANIMATION_BAKEDPALETTES_H_
@@ -24,14 +24,18 @@ Bone::Bone(int bone_id, aiNodeAnim *channel) {
   }
 }
 void Bone::update_local_transformation(double animation_timestamp) {
+  local_transformation = compute_local_transform(animation_timestamp);
+}
+glm::mat4 Bone::compute_local_transform(double animation_timestamp) const {
   auto current_pos = interpolate_vec3(position_keyframes, animation_timestamp);
   auto current_rot = interpolate_quat(rotation_keyframes, animation_timestamp);
   auto current_scale = interpolate_vec3(scale_keyframes, animation_timestamp);
 
-  local_transformation = glm::mat4(1.0f);
-  local_transformation = glm::translate(local_transformation, current_pos);
-  local_transformation *= glm::toMat4(current_rot);
-  local_transformation = glm::scale(local_transformation, current_scale);
+  glm::mat4 transformation = glm::mat4(1.0f);
+  transformation = glm::translate(transformation, current_pos);
+  transformation *= glm::toMat4(current_rot);
+  transformation = glm::scale(transformation, current_scale);
+  return transformation;
 }
 glm::vec3 Bone::interpolate_vec3(const std::vector<Vec3KeyFrame> &keyframes, double timestamp) {
   // If the size is 1, there is nothing to interpolate between
@@ -31,6 +31,10 @@ class Bone {
   // it is NOT a delta time.
   void update_local_transformation(double animation_timestamp);
 
+  // Samples the keyframes at animation_timestamp without touching the cached local transformation,
+  // which makes it safe to use when several instances share the same bone.
+  [[nodiscard]] glm::mat4 compute_local_transform(double animation_timestamp) const;
+
   [[nodiscard]] const glm::mat4 &get_local_transform() const {
 	return local_transformation;
   }
@@ -0,0 +1,94 @@
+//
+// Created by tor on 10/19/26.
+//
+
+#include <algorithm>
+#include "BoneLod.h"
+#include "Model.h"
+
+BoneLodLevel BoneLod::generate_from_influence(const Model &model, float min_influence) {
+  // Sums up how much vertex weight each bone carries
+  std::vector<double> bone_influence(model.get_bone_count(), 0.0);
+  double total_influence = 0.0;
+  for (const auto &mesh : model.mesh_list) {
+	for (const auto &vertex : mesh.vertices) {
+	  for (int i = 0; i < MAX_BONE_PER_VERTEX; i++) {
+		if (vertex.bone_ids[i] < 0) {
+		  continue;
+		}
+		bone_influence[mesh.bone_palette[vertex.bone_ids[i]]] += vertex.bone_weights[i];
+		total_influence += vertex.bone_weights[i];
+	  }
+	}
+  }
+
+  // Children always come after their parent in node_list, so walking it backwards accumulates the influence of
+  // each subtree in its root
+  std::vector<double> subtree_influence(model.node_list.size(), 0.0);
+  for (int i = (int)model.node_list.size() - 1; i >= 0; i--) {
+	const auto &node = model.node_list[i];
+	if (node.bone_index >= 0) {
+	  subtree_influence[i] += bone_influence[model.bone_list[node.bone_index].get_bone_id()];
+	}
+	if (node.parent_index >= 0) {
+	  subtree_influence[node.parent_index] += subtree_influence[i];
+	}
+  }
+
+  std::vector<bool> frozen(model.node_list.size(), false);
+  for (unsigned int i = 0; i < model.node_list.size(); i++) {
+	const auto &node = model.node_list[i];
+	bool parent_frozen = node.parent_index >= 0 && frozen[node.parent_index];
+	// The root is never frozen since it has nothing to follow
+	frozen[i] = parent_frozen
+		|| (node.parent_index >= 0 && subtree_influence[i] < (double)min_influence * total_influence);
+  }
+
+  return build_level(model, frozen);
+}
+
+BoneLodLevel BoneLod::from_bone_names(const Model &model, const std::vector<std::string> &bone_names) {
+  std::vector<bool> frozen(model.node_list.size(), false);
+  for (unsigned int i = 0; i < model.node_list.size(); i++) {
+	const auto &node = model.node_list[i];
+	bool parent_frozen = node.parent_index >= 0 && frozen[node.parent_index];
+	frozen[i] = parent_frozen
+		|| std::find(bone_names.begin(), bone_names.end(), node.node_name) != bone_names.end();
+  }
+
+  return build_level(model, frozen);
+}
+
+BoneLodLevel BoneLod::build_level(const Model &model, const std::vector<bool> &frozen) {
+  BoneLodLevel level{};
+
+  // For every node: the closest evaluated ancestor (or the node itself) and the bind pose transform from that
+  // ancestor to the node
+  std::vector<int> evaluated_ancestor(model.node_list.size(), -1);
+  std::vector<glm::mat4> transform_from_ancestor(model.node_list.size(), glm::mat4(1.0f));
+
+  for (unsigned int i = 0; i < model.node_list.size(); i++) {
+	const auto &node = model.node_list[i];
+	if (!frozen[i]) {
+	  level.evaluated_nodes.push_back(i);
+	  evaluated_ancestor[i] = (int)i;
+	  continue;
+	}
+
+	if (node.parent_index >= 0) {
+	  evaluated_ancestor[i] = evaluated_ancestor[node.parent_index];
+	  // The parent's transform is identity if the parent is the evaluated ancestor itself
+	  transform_from_ancestor[i] = transform_from_ancestor[node.parent_index] * node.transformation;
+	} else {
+	  transform_from_ancestor[i] = node.transformation;
+	}
+
+	if (node.bone_index >= 0) {
+	  int bone_id = model.bone_list[node.bone_index].get_bone_id();
+	  level.frozen_bones.push_back({evaluated_ancestor[i], bone_id,
+									transform_from_ancestor[i] * model.bone_offset_matrix[bone_id]});
+	}
+  }
+
+  return level;
+}
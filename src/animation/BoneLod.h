@@ -0,0 +1,50 @@
+//
+// Created by tor on 10/19/26.
+//
+
+#ifndef OPENGL_SKELETAL_ANIMATION_SRC_ANIMATION_BONELOD_H_
+#define OPENGL_SKELETAL_ANIMATION_SRC_ANIMATION_BONELOD_H_
+
+#include <string>
+#include <vector>
+#include <glm/glm.hpp>
+
+class Model;
+
+// A bone that is not animated at a given LOD level. It rigidly follows its closest evaluated ancestor node.
+struct FrozenBone {
+  // Index into Model::node_list, or -1 if the bone has no evaluated ancestor (i.e. the root is frozen)
+  int ancestor_node = -1;
+  int bone_id = -1;
+  // The bind pose transform from the ancestor's space to the bone's space, multiplied with the bone's offset
+  // matrix. The bone's skinning matrix is then just the ancestor's global transform times this.
+  glm::mat4 rest_transform{1.0f};
+};
+
+// Defines which parts of a skeleton are evaluated at one level of detail. Frozen nodes are neither sampled
+// nor composed into the hierarchy, which is why a frozen node always implies that its whole subtree is frozen.
+struct BoneLodLevel {
+  // Indices into Model::node_list of the nodes that are evaluated, in hierarchy order (parents before children)
+  std::vector<unsigned int> evaluated_nodes{};
+  std::vector<FrozenBone> frozen_bones{};
+};
+
+class BoneLod {
+ public:
+  /**
+   * Generates a LOD level from the influence the bones have on the model's vertices. A bone is frozen if it,
+   * together with all of its descendants, carries less than min_influence of the total vertex weight.
+   * @param model A loaded model, its meshes must still contain their vertices.
+   * @param min_influence Fraction (0-1) of the total vertex weight.
+   */
+  [[nodiscard]] static BoneLodLevel generate_from_influence(const Model &model, float min_influence);
+
+  // Creates a LOD level that freezes the bones with the given names, along with everything below them.
+  [[nodiscard]] static BoneLodLevel from_bone_names(const Model &model, const std::vector<std::string> &bone_names);
+
+ private:
+  // frozen is indexed like Model::node_list and must already be closed under subtrees
+  [[nodiscard]] static BoneLodLevel build_level(const Model &model, const std::vector<bool> &frozen);
+};
+
+#endif //OPENGL_SKELETAL_ANIMATION_SRC_ANIMATION_BONELOD_H_
@@ -0,0 +1,204 @@
+//
+// Created by tor on 10/19/26.
+//
+
+#include <algorithm>
+#include "CpuSkinner.h"
+
+#if defined(__x86_64__) || defined(__i386__)
+#define CPU_SKINNER_X86
+#include <immintrin.h>
+#endif
+
+// Bone ids that are not in the palette leave the vertex in bind pose, just like in the vertex shader
+static glm::vec3 skin_vertex_scalar(const AnimatedVertex &vertex, const glm::mat4 *palette, size_t bone_count,
+									const glm::mat4 &transform) {
+  const glm::vec4 position{vertex.pos, 1.0f};
+  glm::vec4 total_position{0.0f};
+  for (int i = 0; i < MAX_BONE_PER_VERTEX; i++) {
+	if (vertex.bone_ids[i] == -1) {
+	  continue;
+	}
+	if (vertex.bone_ids[i] >= (int)bone_count) {
+	  total_position = transform * position;
+	  break;
+	}
+	total_position += palette[vertex.bone_ids[i]] * position * vertex.bone_weights[i];
+  }
+  return glm::vec3(total_position);
+}
+
+#ifdef CPU_SKINNER_X86
+// Blends the influencing matrices one column at a time & transforms the position with the blended matrix
+static glm::vec3 skin_vertex_sse(const AnimatedVertex &vertex, const glm::mat4 *palette, size_t bone_count,
+								 const glm::mat4 &transform) {
+  __m128 columns[4] = {_mm_setzero_ps(), _mm_setzero_ps(), _mm_setzero_ps(), _mm_setzero_ps()};
+  for (int i = 0; i < MAX_BONE_PER_VERTEX; i++) {
+	if (vertex.bone_ids[i] == -1) {
+	  continue;
+	}
+	if (vertex.bone_ids[i] >= (int)bone_count) {
+	  return glm::vec3(transform * glm::vec4(vertex.pos, 1.0f));
+	}
+	const float *matrix = &palette[vertex.bone_ids[i]][0][0];
+	const __m128 weight = _mm_set1_ps(vertex.bone_weights[i]);
+	for (int column = 0; column < 4; column++) {
+	  columns[column] = _mm_add_ps(columns[column], _mm_mul_ps(_mm_loadu_ps(matrix + column * 4), weight));
+	}
+  }
+
+  __m128 result = _mm_mul_ps(columns[0], _mm_set1_ps(vertex.pos.x));
+  result = _mm_add_ps(result, _mm_mul_ps(columns[1], _mm_set1_ps(vertex.pos.y)));
+  result = _mm_add_ps(result, _mm_mul_ps(columns[2], _mm_set1_ps(vertex.pos.z)));
+  result = _mm_add_ps(result, columns[3]);
+
+  alignas(16) float output[4];
+  _mm_store_ps(output, result);
+  return {output[0], output[1], output[2]};
+}
+
+// Like skin_vertex_sse, but blends two columns per instruction
+__attribute__((target("avx2,fma")))
+static glm::vec3 skin_vertex_avx2(const AnimatedVertex &vertex, const glm::mat4 *palette, size_t bone_count,
+								  const glm::mat4 &transform) {
+  __m256 columns_01 = _mm256_setzero_ps();
+  __m256 columns_23 = _mm256_setzero_ps();
+  for (int i = 0; i < MAX_BONE_PER_VERTEX; i++) {
+	if (vertex.bone_ids[i] == -1) {
+	  continue;
+	}
+	if (vertex.bone_ids[i] >= (int)bone_count) {
+	  return glm::vec3(transform * glm::vec4(vertex.pos, 1.0f));
+	}
+	const float *matrix = &palette[vertex.bone_ids[i]][0][0];
+	const __m256 weight = _mm256_set1_ps(vertex.bone_weights[i]);
+	columns_01 = _mm256_fmadd_ps(_mm256_loadu_ps(matrix), weight, columns_01);
+	columns_23 = _mm256_fmadd_ps(_mm256_loadu_ps(matrix + 8), weight, columns_23);
+  }
+
+  // (column 0 * x + column 2 * z) in the low half & (column 1 * y + column 3) in the high half
+  const __m256 xy = _mm256_setr_ps(vertex.pos.x, vertex.pos.x, vertex.pos.x, vertex.pos.x,
+								   vertex.pos.y, vertex.pos.y, vertex.pos.y, vertex.pos.y);
+  const __m256 z1 = _mm256_setr_ps(vertex.pos.z, vertex.pos.z, vertex.pos.z, vertex.pos.z,
+								   1.0f, 1.0f, 1.0f, 1.0f);
+  const __m256 halves = _mm256_fmadd_ps(columns_01, xy, _mm256_mul_ps(columns_23, z1));
+  const __m128 result = _mm_add_ps(_mm256_castps256_ps128(halves), _mm256_extractf128_ps(halves, 1));
+
+  alignas(16) float output[4];
+  _mm_store_ps(output, result);
+  return {output[0], output[1], output[2]};
+}
+#endif
+
+SimdLevel CpuSkinner::get_best_simd_level() {
+#ifdef CPU_SKINNER_X86
+  if (__builtin_cpu_supports("avx2") && __builtin_cpu_supports("fma")) {
+	return SimdLevel::AVX2;
+  }
+  // SSE2 is part of x86-64, but not of every 32 bit x86 CPU
+  if (__builtin_cpu_supports("sse2")) {
+	return SimdLevel::SSE;
+  }
+#endif
+  return SimdLevel::SCALAR;
+}
+
+CpuSkinner::CpuSkinner(unsigned int thread_count, SimdLevel simd_level)
+	: simd_level(std::min(simd_level, get_best_simd_level())) {
+  // The calling thread skins as well, so one thread less is started
+  for (unsigned int i = 1; i < thread_count; i++) {
+	workers.emplace_back(&CpuSkinner::worker_loop, this);
+  }
+}
+
+CpuSkinner::~CpuSkinner() {
+  {
+	std::lock_guard<std::mutex> lock(mutex);
+	stopping = true;
+  }
+  work_available.notify_all();
+  for (auto &worker : workers) {
+	worker.join();
+  }
+}
+
+void CpuSkinner::skin(const std::vector<AnimatedVertex> &vertices, const glm::mat4 *palette, size_t bone_count,
+					  glm::vec3 *out, const glm::mat4 &transform) {
+  // Skinning is linear, so transforming the palette is the same as transforming every skinned vertex
+  transformed_palette.resize(bone_count);
+  for (size_t bone = 0; bone < bone_count; bone++) {
+	transformed_palette[bone] = transform * palette[bone];
+  }
+  this->transform = transform;
+  this->vertices = vertices.data();
+  this->vertex_count = vertices.size();
+  this->out = out;
+
+  if (workers.empty() || vertex_count <= BLOCK_SIZE) {
+	skin_range(0, vertex_count);
+	return;
+  }
+
+  {
+	std::lock_guard<std::mutex> lock(mutex);
+	next_block = 0;
+	active_workers = (unsigned int)workers.size();
+	generation++;
+  }
+  work_available.notify_all();
+  run_blocks();
+
+  std::unique_lock<std::mutex> lock(mutex);
+  work_done.wait(lock, [this] { return active_workers == 0; });
+}
+
+void CpuSkinner::run_blocks() {
+  const size_t block_count = (vertex_count + BLOCK_SIZE - 1) / BLOCK_SIZE;
+  for (size_t block = next_block++; block < block_count; block = next_block++) {
+	skin_range(block * BLOCK_SIZE, std::min((block + 1) * BLOCK_SIZE, vertex_count));
+  }
+}
+
+void CpuSkinner::skin_range(size_t begin, size_t end) const {
+  const glm::mat4 *palette = transformed_palette.data();
+  const size_t bone_count = transformed_palette.size();
+  switch (simd_level) {
+#ifdef CPU_SKINNER_X86
+	case SimdLevel::AVX2:
+	  for (size_t i = begin; i < end; i++) {
+		out[i] = skin_vertex_avx2(vertices[i], palette, bone_count, transform);
+	  }
+	  return;
+	case SimdLevel::SSE:
+	  for (size_t i = begin; i < end; i++) {
+		out[i] = skin_vertex_sse(vertices[i], palette, bone_count, transform);
+	  }
+	  return;
+#endif
+	default:
+	  for (size_t i = begin; i < end; i++) {
+		out[i] = skin_vertex_scalar(vertices[i], palette, bone_count, transform);
+	  }
+  }
+}
+
+void CpuSkinner::worker_loop() {
+  uint64_t seen_generation = 0;
+  while (true) {
+	{
+	  std::unique_lock<std::mutex> lock(mutex);
+	  work_available.wait(lock, [&] { return stopping || generation != seen_generation; });
+	  if (stopping) {
+		return;
+	  }
+	  seen_generation = generation;
+	}
+
+	run_blocks();
+
+	std::lock_guard<std::mutex> lock(mutex);
+	if (--active_workers == 0) {
+	  work_done.notify_one();
+	}
+  }
+}
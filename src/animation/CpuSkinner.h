@@ -0,0 +1,89 @@
+//
+// Created by tor on 10/19/26.
+//
+
+#ifndef OPENGL_SKELETAL_ANIMATION_SRC_ANIMATION_CPUSKINNER_H_
+#define OPENGL_SKELETAL_ANIMATION_SRC_ANIMATION_CPUSKINNER_H_
+
+#include <atomic>
+#include <condition_variable>
+#include <cstdint>
+#include <mutex>
+#include <thread>
+#include <vector>
+#include <glm/glm.hpp>
+#include "Model.h"
+
+enum class SimdLevel {
+  SCALAR,
+  SSE,
+  // AVX2 together with FMA
+  AVX2,
+};
+
+/**
+ * Skins vertices on the CPU, with the same rules as skeletal_animation_instanced.vert.glsl. Useful as a headless
+ * reference when validating the GPU paths, as a fallback where the GL implementation is slow (e.g. software
+ * renderers), and for CPU-side bounds or ray queries against the posed mesh.
+ * The vertices are split into blocks that are skinned in parallel by a pool of worker threads, each vertex is
+ * skinned with the widest instruction set that the CPU supports.
+ */
+class CpuSkinner {
+ public:
+  // The number of vertices that a thread takes at a time
+  static const size_t BLOCK_SIZE = 1024;
+
+  /**
+   * @param thread_count The number of threads that skin, including the calling thread.
+   * @param simd_level Falls back to the best supported level if the CPU does not support it.
+   */
+  explicit CpuSkinner(unsigned int thread_count = std::thread::hardware_concurrency(),
+					  SimdLevel simd_level = get_best_simd_level());
+  ~CpuSkinner();
+  CpuSkinner(const CpuSkinner &) = delete;
+  CpuSkinner &operator=(const CpuSkinner &) = delete;
+
+  /**
+   * Skins the vertices & writes their positions to out, which must hold vertices.size() positions. Blocks until
+   * every vertex has been skinned.
+   * @param palette The skinning matrices, indexed by bone id.
+   * @param transform Applied after skinning, e.g. a model matrix to get world space positions.
+   */
+  void skin(const std::vector<AnimatedVertex> &vertices, const glm::mat4 *palette, size_t bone_count,
+			glm::vec3 *out, const glm::mat4 &transform = glm::mat4(1.0f));
+
+  [[nodiscard]] SimdLevel get_simd_level() const {
+	return simd_level;
+  }
+
+  [[nodiscard]] unsigned int get_thread_count() const {
+	return (unsigned int)workers.size() + 1;
+  }
+
+  [[nodiscard]] static SimdLevel get_best_simd_level();
+
+ private:
+  // Skins blocks until there are none left in the current job
+  void run_blocks();
+  void skin_range(size_t begin, size_t end) const;
+  void worker_loop();
+
+  SimdLevel simd_level;
+  std::vector<std::thread> workers{};
+  std::mutex mutex{};
+  std::condition_variable work_available{};
+  std::condition_variable work_done{};
+  uint64_t generation = 0;
+  unsigned int active_workers = 0;
+  bool stopping = false;
+
+  // The current job, the palette has the transform applied already
+  std::vector<glm::mat4> transformed_palette{};
+  glm::mat4 transform{1.0f};
+  const AnimatedVertex *vertices = nullptr;
+  size_t vertex_count = 0;
+  glm::vec3 *out = nullptr;
+  std::atomic<size_t> next_block{0};
+};
+
+#endif //OPENGL_SKELETAL_ANIMATION_SRC_ANIMATION_CPUSKINNER_H_
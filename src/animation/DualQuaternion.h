@@ -0,0 +1,51 @@
+//
+// Created by tor on 10/19/26.
+//
+
+#ifndef OPENGL_SKELETAL_ANIMATION_SRC_ANIMATION_DUALQUATERNION_H_
+#define OPENGL_SKELETAL_ANIMATION_SRC_ANIMATION_DUALQUATERNION_H_
+
+#include <cstddef>
+#include <glm/glm.hpp>
+#include <glm/gtx/quaternion.hpp>
+
+// A rigid transform (rotation & translation) stored as a unit dual quaternion, in half the space of a matrix.
+// Matches DualQuaternion in skeletal_animation_instanced.vert.glsl (std430 layout).
+struct DualQuaternion {
+  // The rotation, xyz is the vector part & w the scalar part
+  glm::vec4 real{0.0f, 0.0f, 0.0f, 1.0f};
+  // Half the translation (as a pure quaternion) multiplied by the rotation
+  glm::vec4 dual{0.0f};
+
+  // Any scale or shear in the matrix is dropped
+  [[nodiscard]] static DualQuaternion from_matrix(const glm::mat4 &matrix) {
+	const glm::mat3 rotation{glm::normalize(glm::vec3(matrix[0])),
+							 glm::normalize(glm::vec3(matrix[1])),
+							 glm::normalize(glm::vec3(matrix[2]))};
+	const glm::quat q = glm::quat_cast(rotation);
+	const glm::vec3 vector{q.x, q.y, q.z};
+	const glm::vec3 translation{matrix[3]};
+
+	DualQuaternion result;
+	result.real = glm::vec4(vector, q.w);
+	result.dual = 0.5f * glm::vec4(q.w * translation + glm::cross(translation, vector), -glm::dot(translation, vector));
+	return result;
+  }
+
+  // Transforms the point like the matrix it was created from, as long as that matrix was rigid
+  [[nodiscard]] glm::vec3 transform_point(const glm::vec3 &point) const {
+	const glm::vec3 real_vector{real};
+	const glm::vec3 dual_vector{dual};
+	const glm::vec3 rotated = point + 2.0f * glm::cross(real_vector, glm::cross(real_vector, point) + real.w * point);
+	return rotated + 2.0f * (real.w * dual_vector - dual.w * real_vector + glm::cross(real_vector, dual_vector));
+  }
+};
+
+// Converts count (blended) skinning matrices, see blend_palettes
+inline void convert_palette(const glm::mat4 *matrices, DualQuaternion *out, size_t count) {
+  for (size_t i = 0; i < count; i++) {
+	out[i] = DualQuaternion::from_matrix(matrices[i]);
+  }
+}
+
+#endif //OPENGL_SKELETAL_ANIMATION_SRC_ANIMATION_DUALQUATERNION_H_
@@ -0,0 +1,410 @@
+//
+// Created by tor on 10/19/26.
+//
+
+#include <algorithm>
+#include <cmath>
+#include <cstring>
+#include <deque>
+#include <functional>
+#include <iterator>
+#include <numeric>
+#include <string_view>
+#include <unordered_map>
+#include "MeshOptimizer.h"
+
+// Tuned constants from Forsyth's article
+static const float CACHE_DECAY_POWER = 1.5f;
+static const float LAST_TRIANGLE_SCORE = 0.75f;
+static const float VALENCE_BOOST_SCALE = 2.0f;
+static const float VALENCE_BOOST_POWER = 0.5f;
+
+static float get_vertex_score(int cache_position, unsigned int remaining_triangles) {
+  if (remaining_triangles == 0) {
+	// The vertex is not used by any more triangles, so it should not attract any
+	return -1.0f;
+  }
+
+  float score = 0.0f;
+  if (cache_position >= 0) {
+	if (cache_position < 3) {
+	  // The vertices of the triangle that was just drawn get a fixed score, so that the next triangle does not
+	  // simply reuse the most recent edge
+	  score = LAST_TRIANGLE_SCORE;
+	} else {
+	  const float scale = 1.0f / (float)(MeshOptimizer::CACHE_SIZE - 3);
+	  score = std::pow(1.0f - (float)(cache_position - 3) * scale, CACHE_DECAY_POWER);
+	}
+  }
+  // Vertices with few triangles left are prioritized, so that lone triangles are not left behind
+  score += VALENCE_BOOST_SCALE * std::pow((float)remaining_triangles, -VALENCE_BOOST_POWER);
+  return score;
+}
+
+// Vertices are compared byte for byte, which requires every byte to belong to a member
+static_assert(sizeof(AnimatedVertex) == sizeof(glm::vec3) + sizeof(glm::vec2)
+	+ MAX_BONE_PER_VERTEX * (sizeof(int) + sizeof(float)), "AnimatedVertex has padding");
+
+void MeshOptimizer::weld_vertices(Mesh &mesh) {
+  auto get_bytes = [](const AnimatedVertex &vertex) {
+	return std::string_view((const char *)&vertex, sizeof(AnimatedVertex));
+  };
+
+  std::unordered_map<std::string_view, unsigned int> unique_indices;
+  unique_indices.reserve(mesh.vertices.size());
+  std::vector<unsigned int> remap(mesh.vertices.size());
+  std::vector<AnimatedVertex> vertices;
+  vertices.reserve(mesh.vertices.size());
+  for (size_t i = 0; i < mesh.vertices.size(); i++) {
+	auto [unique, inserted] = unique_indices.try_emplace(get_bytes(mesh.vertices[i]), (unsigned int)vertices.size());
+	if (inserted) {
+	  vertices.push_back(mesh.vertices[i]);
+	}
+	remap[i] = unique->second;
+  }
+  if (vertices.size() == mesh.vertices.size()) {
+	return;
+  }
+
+  for (auto &index : mesh.indices) {
+	index = remap[index];
+  }
+  mesh.vertices = std::move(vertices);
+}
+
+// The number of influences that actually move the vertex
+static unsigned int get_influence_count(const AnimatedVertex &vertex) {
+  unsigned int influence_count = 0;
+  for (int i = 0; i < MAX_BONE_PER_VERTEX; i++) {
+	if (vertex.bone_ids[i] >= 0 && vertex.bone_weights[i] != 0.0f) {
+	  influence_count++;
+	}
+  }
+  return influence_count;
+}
+
+std::vector<Mesh> MeshOptimizer::split_by_influence_count(const Mesh &source) {
+  // The palette is compacted before splitting, so that every part keeps the same local palette & the parts share a
+  // single copy of it in the model's draw palette
+  Mesh mesh = source;
+  compact_bone_palette(mesh);
+
+  const unsigned int part_influence_counts[] = {1, 2, MAX_BONE_PER_VERTEX};
+  std::vector<Mesh> parts(std::size(part_influence_counts));
+  for (size_t i = 0; i < parts.size(); i++) {
+	parts[i].vertices = mesh.vertices;
+	parts[i].bone_palette = mesh.bone_palette;
+	parts[i].influence_count = part_influence_counts[i];
+  }
+
+  for (size_t triangle = 0; triangle + 2 < mesh.indices.size(); triangle += 3) {
+	unsigned int influence_count = 0;
+	for (int corner = 0; corner < 3; corner++) {
+	  influence_count = std::max(influence_count, get_influence_count(mesh.vertices[mesh.indices[triangle + corner]]));
+	}
+	size_t part = 0;
+	while (part_influence_counts[part] < influence_count) {
+	  part++;
+	}
+	parts[part].indices.insert(parts[part].indices.end(), mesh.indices.begin() + (long)triangle,
+							   mesh.indices.begin() + (long)triangle + 3);
+  }
+
+  std::vector<Mesh> result;
+  for (auto &part : parts) {
+	if (part.indices.empty()) {
+	  continue;
+	}
+	// Drops the vertices that are only used by the other parts
+	optimize_vertex_fetch(part);
+	if (part.influence_count < MAX_BONE_PER_VERTEX) {
+	  for (auto &vertex : part.vertices) {
+		AnimatedVertex compacted{};
+		unsigned int slot = 0;
+		for (int i = 0; i < MAX_BONE_PER_VERTEX; i++) {
+		  if (vertex.bone_ids[i] >= 0 && vertex.bone_weights[i] != 0.0f) {
+			compacted.bone_ids[slot] = vertex.bone_ids[i];
+			compacted.bone_weights[slot] = vertex.bone_weights[i];
+			slot++;
+		  }
+		}
+		for (; slot < MAX_BONE_PER_VERTEX; slot++) {
+		  compacted.bone_ids[slot] = 0;
+		}
+		std::copy(compacted.bone_ids, compacted.bone_ids + MAX_BONE_PER_VERTEX, vertex.bone_ids);
+		std::copy(compacted.bone_weights, compacted.bone_weights + MAX_BONE_PER_VERTEX, vertex.bone_weights);
+	  }
+	}
+	result.push_back(std::move(part));
+  }
+  return result;
+}
+
+void MeshOptimizer::compact_bone_palette(Mesh &mesh) {
+  // Unused slots of reduced influence counts refer to bone 0 with a weight of 0, which still has to be valid
+  std::vector<bool> used(mesh.bone_palette.size(), false);
+  for (const auto &vertex : mesh.vertices) {
+	for (int i = 0; i < MAX_BONE_PER_VERTEX; i++) {
+	  if (vertex.bone_ids[i] >= 0 && (vertex.bone_weights[i] != 0.0f || mesh.influence_count < MAX_BONE_PER_VERTEX)) {
+		used[vertex.bone_ids[i]] = true;
+	  }
+	}
+  }
+
+  // The unused slots of reduced influence counts refer to bone 0, so at least one bone is kept
+  if (!mesh.bone_palette.empty() && std::find(used.begin(), used.end(), true) == used.end()) {
+	used[0] = true;
+  }
+
+  std::vector<int> remap(mesh.bone_palette.size(), -1);
+  std::vector<unsigned int> bone_palette;
+  for (size_t bone = 0; bone < mesh.bone_palette.size(); bone++) {
+	if (used[bone]) {
+	  remap[bone] = (int)bone_palette.size();
+	  bone_palette.push_back(mesh.bone_palette[bone]);
+	}
+  }
+  if (bone_palette.size() == mesh.bone_palette.size()) {
+	return;
+  }
+
+  // Influences without any weight are dropped along with their bone
+  for (auto &vertex : mesh.vertices) {
+	for (int i = 0; i < MAX_BONE_PER_VERTEX; i++) {
+	  if (vertex.bone_ids[i] >= 0) {
+		vertex.bone_ids[i] = remap[vertex.bone_ids[i]];
+		if (vertex.bone_ids[i] < 0) {
+		  vertex.bone_weights[i] = 0.0f;
+		}
+	  }
+	}
+  }
+  mesh.bone_palette = std::move(bone_palette);
+}
+
+void MeshOptimizer::optimize(Mesh &mesh, bool reduce_overdraw) {
+  optimize_vertex_cache(mesh.indices, mesh.vertices.size());
+  if (reduce_overdraw) {
+	optimize_overdraw(mesh.indices, mesh.vertices);
+  }
+  optimize_vertex_fetch(mesh);
+}
+
+void MeshOptimizer::optimize_vertex_cache(std::vector<unsigned int> &indices, size_t vertex_count) {
+  const size_t triangle_count = indices.size() / 3;
+  if (triangle_count == 0) {
+	return;
+  }
+
+  // The triangles that use every vertex, stored back to back
+  std::vector<unsigned int> triangle_offsets(vertex_count + 1, 0);
+  for (auto index : indices) {
+	triangle_offsets[index + 1]++;
+  }
+  std::partial_sum(triangle_offsets.begin(), triangle_offsets.end(), triangle_offsets.begin());
+  std::vector<unsigned int> vertex_triangles(indices.size());
+  std::vector<unsigned int> remaining_triangles(vertex_count, 0);
+  for (size_t triangle = 0; triangle < triangle_count; triangle++) {
+	for (int corner = 0; corner < 3; corner++) {
+	  auto vertex = indices[triangle * 3 + corner];
+	  vertex_triangles[triangle_offsets[vertex] + remaining_triangles[vertex]++] = (unsigned int)triangle;
+	}
+  }
+
+  std::vector<int> cache_positions(vertex_count, -1);
+  std::vector<float> vertex_scores(vertex_count);
+  for (size_t vertex = 0; vertex < vertex_count; vertex++) {
+	vertex_scores[vertex] = get_vertex_score(-1, remaining_triangles[vertex]);
+  }
+  std::vector<bool> emitted(triangle_count, false);
+  std::vector<unsigned int> optimized;
+  optimized.reserve(indices.size());
+  // Holds up to 3 vertices more than the cache while a triangle is added
+  std::vector<unsigned int> cache;
+  cache.reserve(CACHE_SIZE + 3);
+  size_t next_unemitted = 0;
+  long best_triangle = -1;
+
+  while (optimized.size() < indices.size()) {
+	if (best_triangle < 0) {
+	  // Nothing in the cache is worth drawing, so continue with the next triangle in the original order
+	  while (emitted[next_unemitted]) {
+		next_unemitted++;
+	  }
+	  best_triangle = (long)next_unemitted;
+	}
+
+	emitted[best_triangle] = true;
+	std::vector<unsigned int> new_cache;
+	new_cache.reserve(CACHE_SIZE + 3);
+	for (int corner = 0; corner < 3; corner++) {
+	  auto vertex = indices[best_triangle * 3 + corner];
+	  optimized.push_back(vertex);
+	  new_cache.push_back(vertex);
+
+	  // Removes the triangle from the vertex's remaining triangles
+	  auto begin = vertex_triangles.begin() + triangle_offsets[vertex];
+	  auto end = begin + remaining_triangles[vertex];
+	  std::iter_swap(std::find(begin, end, (unsigned int)best_triangle), end - 1);
+	  remaining_triangles[vertex]--;
+	}
+	for (auto vertex : cache) {
+	  if (std::find(new_cache.begin(), new_cache.end(), vertex) == new_cache.end()) {
+		new_cache.push_back(vertex);
+	  }
+	}
+
+	// Vertices that fell out of the cache lose their cache score
+	for (size_t i = CACHE_SIZE; i < new_cache.size(); i++) {
+	  cache_positions[new_cache[i]] = -1;
+	  vertex_scores[new_cache[i]] = get_vertex_score(-1, remaining_triangles[new_cache[i]]);
+	}
+	new_cache.resize(std::min<size_t>(new_cache.size(), CACHE_SIZE));
+	cache = std::move(new_cache);
+
+	for (size_t i = 0; i < cache.size(); i++) {
+	  cache_positions[cache[i]] = (int)i;
+	  vertex_scores[cache[i]] = get_vertex_score((int)i, remaining_triangles[cache[i]]);
+	}
+
+	// Only the triangles that use a cached vertex changed their score, the best of them is drawn next
+	best_triangle = -1;
+	float best_score = -1.0f;
+	for (auto vertex : cache) {
+	  for (unsigned int i = 0; i < remaining_triangles[vertex]; i++) {
+		auto triangle = vertex_triangles[triangle_offsets[vertex] + i];
+		float score = vertex_scores[indices[triangle * 3]] + vertex_scores[indices[triangle * 3 + 1]]
+			+ vertex_scores[indices[triangle * 3 + 2]];
+		if (score > best_score) {
+		  best_score = score;
+		  best_triangle = triangle;
+		}
+	  }
+	}
+  }
+
+  indices = std::move(optimized);
+}
+
+void MeshOptimizer::optimize_overdraw(std::vector<unsigned int> &indices, const std::vector<AnimatedVertex> &vertices) {
+  const size_t triangle_count = indices.size() / 3;
+  if (triangle_count == 0) {
+	return;
+  }
+
+  // A cluster ends wherever the cache has been flushed, i.e. at a triangle where every vertex misses. Reordering
+  // the clusters therefore costs almost nothing in cache efficiency.
+  std::vector<size_t> cluster_starts{0};
+  std::deque<unsigned int> cache;
+  for (size_t triangle = 0; triangle < triangle_count; triangle++) {
+	int misses = 0;
+	for (int corner = 0; corner < 3; corner++) {
+	  auto vertex = indices[triangle * 3 + corner];
+	  if (std::find(cache.begin(), cache.end(), vertex) == cache.end()) {
+		misses++;
+		cache.push_back(vertex);
+		if (cache.size() > ANALYSIS_CACHE_SIZE) {
+		  cache.pop_front();
+		}
+	  }
+	}
+	if (misses == 3 && triangle > cluster_starts.back()) {
+	  cluster_starts.push_back(triangle);
+	}
+  }
+  cluster_starts.push_back(triangle_count);
+
+  glm::vec3 mesh_centroid{0.0f};
+  for (const auto &vertex : vertices) {
+	mesh_centroid += vertex.pos;
+  }
+  mesh_centroid /= (float)std::max<size_t>(vertices.size(), 1);
+
+  // Clusters that face away from the center are on the outside of the mesh, so they are likely to occlude the
+  // others & are drawn first
+  struct Cluster {
+	size_t first_triangle;
+	size_t triangle_count;
+	float sort_key;
+  };
+  std::vector<Cluster> clusters;
+  for (size_t i = 0; i + 1 < cluster_starts.size(); i++) {
+	glm::vec3 centroid{0.0f};
+	glm::vec3 normal{0.0f};
+	float total_area = 0.0f;
+	for (size_t triangle = cluster_starts[i]; triangle < cluster_starts[i + 1]; triangle++) {
+	  const auto &a = vertices[indices[triangle * 3]].pos;
+	  const auto &b = vertices[indices[triangle * 3 + 1]].pos;
+	  const auto &c = vertices[indices[triangle * 3 + 2]].pos;
+	  // The cross product is weighted by the triangle's area
+	  auto area_normal = glm::cross(b - a, c - a);
+	  float area = glm::length(area_normal);
+	  centroid += (a + b + c) / 3.0f * area;
+	  normal += area_normal;
+	  total_area += area;
+	}
+	// The normals of a curved or closed cluster (partly) cancel out, so its direction is only used if one is left
+	const float normal_length = glm::length(normal);
+	const size_t count = cluster_starts[i + 1] - cluster_starts[i];
+	float sort_key = 0.0f;
+	if (total_area > 0.0f && normal_length > 0.0f) {
+	  sort_key = glm::dot(centroid / total_area - mesh_centroid, normal / normal_length);
+	}
+	clusters.push_back({cluster_starts[i], count, sort_key});
+  }
+  std::stable_sort(clusters.begin(), clusters.end(), [](const Cluster &a, const Cluster &b) {
+	return a.sort_key > b.sort_key;
+  });
+
+  std::vector<unsigned int> sorted;
+  sorted.reserve(indices.size());
+  for (const auto &cluster : clusters) {
+	auto begin = indices.begin() + (long)(cluster.first_triangle * 3);
+	sorted.insert(sorted.end(), begin, begin + (long)(cluster.triangle_count * 3));
+  }
+  indices = std::move(sorted);
+}
+
+void MeshOptimizer::optimize_vertex_fetch(Mesh &mesh) {
+  const unsigned int unused = ~0u;
+  std::vector<unsigned int> remap(mesh.vertices.size(), unused);
+  std::vector<AnimatedVertex> vertices;
+  vertices.reserve(mesh.vertices.size());
+  for (auto &index : mesh.indices) {
+	if (remap[index] == unused) {
+	  remap[index] = (unsigned int)vertices.size();
+	  vertices.push_back(mesh.vertices[index]);
+	}
+	index = remap[index];
+  }
+  mesh.vertices = std::move(vertices);
+}
+
+VertexCacheStats MeshOptimizer::analyze_vertex_cache(const std::vector<unsigned int> &indices,
+													 size_t vertex_count,
+													 unsigned int cache_size) {
+  VertexCacheStats stats;
+  if (indices.empty()) {
+	return stats;
+  }
+
+  // A FIFO cache is simulated with the time each vertex entered it
+  std::vector<size_t> cache_entry_time(vertex_count, 0);
+  std::vector<bool> used(vertex_count, false);
+  size_t transformed = 0;
+  size_t unique = 0;
+  for (auto index : indices) {
+	if (!used[index]) {
+	  used[index] = true;
+	  unique++;
+	}
+	if (cache_entry_time[index] == 0 || transformed - cache_entry_time[index] >= cache_size) {
+	  transformed++;
+	  cache_entry_time[index] = transformed;
+	}
+  }
+
+  stats.acmr = (float)transformed / (float)(indices.size() / 3);
+  stats.atvr = (float)transformed / (float)unique;
+  return stats;
+}
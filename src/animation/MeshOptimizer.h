@@ -0,0 +1,67 @@
+//
+// Created by tor on 10/19/26.
+//
+
+#ifndef OPENGL_SKELETAL_ANIMATION_SRC_ANIMATION_MESHOPTIMIZER_H_
+#define OPENGL_SKELETAL_ANIMATION_SRC_ANIMATION_MESHOPTIMIZER_H_
+
+#include <vector>
+#include "Model.h"
+
+// How well an index buffer uses the post-transform vertex cache
+struct VertexCacheStats {
+  // Average cache miss ratio: vertex shader invocations per triangle, 0.5 is the best possible & 3 the worst
+  float acmr = 0.0f;
+  // Average transform to vertex ratio: vertex shader invocations per unique vertex, 1 is the best possible
+  float atvr = 0.0f;
+};
+
+/**
+ * Reorders a mesh's triangles & vertices so that it takes fewer (expensive, skinned) vertex shader invocations
+ * to draw:
+ * - Triangles are ordered for the post-transform vertex cache with Tom Forsyth's "Linear-Speed Vertex Cache
+ *   Optimisation".
+ * - Optionally, the cache-friendly triangle order is then split into clusters that are drawn front to back,
+ *   roughly in the order of the direction they face, to reduce overdraw (as in Sander et al. "Fast Triangle
+ *   Reordering for Vertex Locality and Reduced Overdraw").
+ * - Vertices are then stored in the order they are first used, for locality when they are fetched.
+ * Identical vertices can also be welded beforehand, so that they are only transformed once.
+ */
+class MeshOptimizer {
+ public:
+  // The size of the LRU cache modelled by the triangle ordering
+  static const unsigned int CACHE_SIZE = 32;
+  // The size of the FIFO cache that is simulated when analyzing, which is typical for actual hardware
+  static const unsigned int ANALYSIS_CACHE_SIZE = 16;
+
+  // Merges vertices whose position, texture coordinates & bone influences are all identical, which is common since
+  // the normals that tell them apart on import are not kept
+  static void weld_vertices(Mesh &mesh);
+
+  /**
+   * Splits the mesh by the number of bones that influence each triangle (1, 2 or MAX_BONE_PER_VERTEX), so that
+   * rigid parts can be skinned without reading & branching over unused influences. Vertices that are shared by
+   * triangles of different parts are duplicated. See Mesh::influence_count for what the parts guarantee.
+   * Every part keeps the (compacted) local palette of the source mesh.
+   */
+  [[nodiscard]] static std::vector<Mesh> split_by_influence_count(const Mesh &source);
+
+  // Drops the bones that no vertex of the mesh is influenced by from its local palette & renumbers the rest
+  static void compact_bone_palette(Mesh &mesh);
+
+  // Runs every optimization in the right order, the vertices must have their bone weights already
+  static void optimize(Mesh &mesh, bool reduce_overdraw = true);
+
+  static void optimize_vertex_cache(std::vector<unsigned int> &indices, size_t vertex_count);
+
+  static void optimize_overdraw(std::vector<unsigned int> &indices, const std::vector<AnimatedVertex> &vertices);
+
+  // Reorders the vertices in the order that the indices first use them, vertices that are never used are dropped
+  static void optimize_vertex_fetch(Mesh &mesh);
+
+  [[nodiscard]] static VertexCacheStats analyze_vertex_cache(const std::vector<unsigned int> &indices,
+															 size_t vertex_count,
+															 unsigned int cache_size = ANALYSIS_CACHE_SIZE);
+};
+
+#endif //OPENGL_SKELETAL_ANIMATION_SRC_ANIMATION_MESHOPTIMIZER_H_
@@ -2,52 +2,134 @@
 // Created by tor on 3/23/23.
 //
 
+#include <algorithm>
+#include <cmath>
 #include <optional>
 #include <iostream>
 #include "Model.h"
 
-Model::Model() {
-  skinning_matrices.reserve(MAX_BONES_PER_MODEL);
-  for (int i = 0; i < MAX_BONES_PER_MODEL; i++) {
-	skinning_matrices.emplace_back(1.0f);
+Model::Model() = default;
+
+void Model::update_palette_offsets() {
+  draw_palette.clear();
+  for (size_t i = 0; i < mesh_list.size(); i++) {
+	auto &mesh = mesh_list[i];
+	auto shared = std::find_if(mesh_list.begin(), mesh_list.begin() + (long)i, [&](const Mesh &other) {
+	  return other.bone_palette == mesh.bone_palette;
+	});
+	if (shared != mesh_list.begin() + (long)i) {
+	  mesh.palette_offset = shared->palette_offset;
+	  continue;
+	}
+	mesh.palette_offset = (unsigned int)draw_palette.size();
+	draw_palette.insert(draw_palette.end(), mesh.bone_palette.begin(), mesh.bone_palette.end());
+  }
+}
+
+void Model::gather_palette(const glm::mat4 *bone_matrices, glm::mat4 *out) const {
+  for (auto bone : draw_palette) {
+	*out++ = bone_matrices[bone];
   }
 }
 
 void Model::update_skinning_matrix(double delta_time) {
   auto current_time = update_time(delta_time);
-  std::vector<glm::mat4> parentTransforms;
+  evaluate_pose(current_time, skinning_matrices);
+}
+
+void Model::evaluate_pose(double animation_time,
+						  std::vector<glm::mat4> &out_skinning_matrices,
+						  unsigned int bone_lod) const {
+  if (sampling_mode != SamplingMode::KEYFRAMES && baked_palettes) {
+	baked_palettes->sample(animation_time, sampling_mode == SamplingMode::BAKED_INTERPOLATED, out_skinning_matrices);
+	return;
+  }
+  evaluate_keyframes(animation_time, out_skinning_matrices, bone_lod);
+}
 
-  for (const auto &nodeData : node_list) {
-	auto nodeTransform = nodeData.transformation;
+void Model::evaluate_keyframes(double animation_time,
+							   std::vector<glm::mat4> &out_skinning_matrices,
+							   unsigned int bone_lod) const {
+  std::vector<glm::mat4> globalTransforms(node_list.size());
 
-	if (nodeData.bone_index >= 0) {
-	  auto &bone = bone_list[nodeData.bone_index];
-	  bone.update_local_transformation(current_time);
-	  nodeTransform = bone.get_local_transform();
+  if (bone_lod == 0 || bone_lod > bone_lod_levels.size()) {
+	for (unsigned int i = 0; i < node_list.size(); i++) {
+	  evaluate_node(i, animation_time, globalTransforms, out_skinning_matrices);
 	}
+	return;
+  }
 
-	glm::mat4
-		parentTransform = nodeData.parent_index != -1 ? parentTransforms[nodeData.parent_index] : glm::mat4(1.0f);
-	glm::mat4 globalTransformation = parentTransform * nodeTransform;
-	parentTransforms.push_back(globalTransformation);
+  // Frozen nodes are skipped entirely, their bones just follow the closest evaluated ancestor
+  const auto &level = bone_lod_levels[bone_lod - 1];
+  for (auto node_index : level.evaluated_nodes) {
+	evaluate_node(node_index, animation_time, globalTransforms, out_skinning_matrices);
+  }
+  for (const auto &frozen : level.frozen_bones) {
+	out_skinning_matrices[frozen.bone_id] = frozen.ancestor_node >= 0
+											? globalTransforms[frozen.ancestor_node] * frozen.rest_transform
+											: frozen.rest_transform;
+  }
+}
 
-	if (nodeData.bone_index >= 0) {
-	  auto &bone = bone_list[nodeData.bone_index];
-	  glm::mat4 offset = bone_offset_matrix[bone.get_bone_id()];
-	  skinning_matrices[bone.get_bone_id()] = globalTransformation * offset;
-	}
+void Model::evaluate_node(unsigned int node_index,
+						  double animation_time,
+						  std::vector<glm::mat4> &global_transforms,
+						  std::vector<glm::mat4> &out_skinning_matrices) const {
+  const auto &nodeData = node_list[node_index];
+  auto nodeTransform = nodeData.transformation;
+
+  if (nodeData.bone_index >= 0) {
+	nodeTransform = bone_list[nodeData.bone_index].compute_local_transform(animation_time);
+  }
+
+  glm::mat4
+	  parentTransform = nodeData.parent_index != -1 ? global_transforms[nodeData.parent_index] : glm::mat4(1.0f);
+  glm::mat4 globalTransformation = parentTransform * nodeTransform;
+  global_transforms[node_index] = globalTransformation;
+
+  if (nodeData.bone_index >= 0) {
+	const auto &bone = bone_list[nodeData.bone_index];
+	glm::mat4 offset = bone_offset_matrix[bone.get_bone_id()];
+	out_skinning_matrices[bone.get_bone_id()] = globalTransformation * offset;
+  }
+}
+
+void Model::bake_palettes(double frame_rate, SamplingMode mode) {
+  baked_palettes = create_baked_palettes(frame_rate);
+  sampling_mode = mode;
+}
+
+BakedPalettes Model::create_baked_palettes(double frame_rate) const {
+  BakedPalettes baked{};
+  baked.frame_length = (ticks_per_second > 0.0 ? ticks_per_second : 1.0) / frame_rate;
+  baked.animation_duration = animation_duration;
+  baked.frame_count = std::max((unsigned int)std::ceil(animation_duration / baked.frame_length), 1u);
+  baked.bone_count = get_bone_count();
+  baked.skinning_matrices.reserve(baked.frame_count * baked.bone_count);
+
+  std::vector<glm::mat4> frame_skinning_matrices = skinning_matrices;
+  for (unsigned int frame = 0; frame < baked.frame_count; frame++) {
+	evaluate_keyframes(frame * baked.frame_length, frame_skinning_matrices, 0);
+	baked.skinning_matrices.insert(baked.skinning_matrices.end(),
+								   frame_skinning_matrices.begin(),
+								   frame_skinning_matrices.begin() + baked.bone_count);
   }
+  return baked;
 }
 
 double Model::update_time(double delta_time) {
+  current_animation_time = advance_time(current_animation_time, delta_time);
+  return current_animation_time;
+}
+
+double Model::advance_time(double animation_time, double delta_time) const {
   if (ticks_per_second > 0.0f) {
-	current_animation_time += delta_time * ticks_per_second;
+	animation_time += delta_time * ticks_per_second;
   } else {
-	current_animation_time += delta_time;
+	animation_time += delta_time;
   }
 
-  current_animation_time = std::fmod(current_animation_time, animation_duration);
-  return current_animation_time;
+  return std::fmod(animation_time, animation_duration);
 }
 
 std::optional<std::pair<Bone, int>> Model::get_bone_by_name(const std::string &bone_name) const {
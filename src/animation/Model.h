@@ -5,6 +5,7 @@
 #ifndef OPENGL_SKELETAL_ANIMATION_SRC_MODELS_MODEL_H_
 #define OPENGL_SKELETAL_ANIMATION_SRC_MODELS_MODEL_H_
 
+#include <memory>
 #include <optional>
 #include <utility>
 #include <vector>
@@ -14,9 +15,10 @@
 #include <assimp/scene.h>
 #include "Conversions.h"
 #include "Bone.h"
+#include "BoneLod.h"
+#include "BakedPalettes.h"
 
 static const int MAX_BONE_PER_VERTEX = 4;
-static const int MAX_BONES_PER_MODEL = 128;
 
 // This means that bone_ids[i] impacts this vertex with weight bone_weights[i]
 // NOTE: bone_weights is not actually unused, it gets sent to the vertex shader buffers
@@ -46,10 +48,35 @@ struct AnimatedVertex {
   }
 };
 
+// Where a mesh's vertices & indices are stored in the shared buffers of a MeshArena. It is shared by the arena,
+// which updates the offsets when it is defragmented, and every copy of the mesh.
+struct MeshAllocation {
+  unsigned int base_vertex = 0;
+  unsigned int vertex_count = 0;
+  // In units of index_size
+  unsigned int first_index = 0;
+  unsigned int index_count = 0;
+  // The size in bytes of each index, 2 or 4, see get_index_size
+  unsigned int index_size = sizeof(unsigned int);
+  // Turns the positions stored in the arena back into model space, the identity unless they are quantized
+  glm::vec3 position_scale{1.0f};
+  glm::vec3 position_offset{0.0f};
+};
+
 struct Mesh {
   std::vector<AnimatedVertex> vertices;
   std::vector<unsigned int> indices;
-  unsigned int vao, vbo, ebo;
+  // Unless it is MAX_BONE_PER_VERTEX, every vertex's influences are stored in the first influence_count slots and
+  // unused slots have bone id 0 & weight 0. Such meshes are drawn with a cheaper skinning shader variant, see
+  // MeshOptimizer::split_by_influence_count
+  unsigned int influence_count = MAX_BONE_PER_VERTEX;
+  // The vertices' bone ids index into this local palette, which holds the model's bone id of every bone that the
+  // mesh uses. Each draw only needs the bones of its mesh, however many bones the model has.
+  std::vector<unsigned int> bone_palette{};
+  // Index of the mesh's local palette within the model's draw palette, see Model::update_palette_offsets
+  unsigned int palette_offset = 0;
+  // Set once the mesh has been added to a MeshArena
+  std::shared_ptr<MeshAllocation> allocation{};
 };
 
 struct Node {
@@ -71,6 +98,8 @@ class Model {
   std::optional<unsigned int> texture_id = std::nullopt;
 
   std::vector<Mesh> mesh_list{};
+  // The VAO of the MeshArena that holds the meshes, 0 until the model is added to one
+  unsigned int vao = 0;
   std::vector<Node> node_list{};
   std::vector<Bone> bone_list{};
 
@@ -82,6 +111,19 @@ class Model {
   double current_animation_time = 0.0;
   double ticks_per_second = -1.0f;
   double animation_duration = 0.0f;
+  SamplingMode sampling_mode = SamplingMode::KEYFRAMES;
+  std::optional<BakedPalettes> baked_palettes = std::nullopt;
+
+  // The model's clip in the AnimationTexture it was added to, -1 until it is added to one
+  int animation_texture_clip = -1;
+  // The model's clip in the VertexAnimationTexture it was added to, -1 until it is added to one
+  int vertex_animation_clip = -1;
+
+  // Bone LOD level n (n >= 1) is stored at index n - 1, level 0 always evaluates the full skeleton
+  std::vector<BoneLodLevel> bone_lod_levels{};
+
+  // Radius of a sphere around the model origin that encloses every vertex in bind pose (model space).
+  float bounding_radius = 0.0f;
 
   // The matrices that transform vertex positions from their local space to their transformed and
   // animated position. This gets copied to the GPU (vertex shader) to transform the vertices
@@ -89,6 +131,49 @@ class Model {
 
   void update_skinning_matrix(double delta_time);
 
+  // Samples the animation at animation_time and writes the resulting skinning matrices to out_skinning_matrices.
+  // Unlike update_skinning_matrix this does not modify the model, so one model can be shared by many instances.
+  // bone_lod selects one of the bone_lod_levels, bones frozen at that level are not sampled. Bone LOD does not
+  // apply when sampling baked palettes, since those are already fully evaluated.
+  void evaluate_pose(double animation_time,
+					 std::vector<glm::mat4> &out_skinning_matrices,
+					 unsigned int bone_lod = 0) const;
+
+  // Evaluates the full palette frame_rate times per second of animation and switches to the given (baked)
+  // sampling mode.
+  void bake_palettes(double frame_rate, SamplingMode mode);
+
+  // Evaluates the full palette frame_rate times per second of animation from the keyframes, without changing how
+  // the model is sampled
+  [[nodiscard]] BakedPalettes create_baked_palettes(double frame_rate) const;
+
+  // Returns animation_time advanced by delta_time (in seconds), wrapped to the animation duration.
+  [[nodiscard]] double advance_time(double animation_time, double delta_time) const;
+
+  // The number of bones that are actually used by the model's meshes
+  [[nodiscard]] int get_bone_count() const {
+	return next_bone_id;
+  }
+
+  // Lays the local palettes of the meshes out one after another in the model's draw palette, which is what the
+  // GPU paths read. Meshes with identical local palettes (e.g. the parts split from the same source mesh) share a
+  // single copy. Has to be called whenever the meshes or their bone palettes change.
+  void update_palette_offsets();
+
+  // The number of entries in the draw palette. Bones used by meshes with different local palettes are counted once
+  // per palette, so this can exceed get_bone_count() for models made of many meshes.
+  [[nodiscard]] unsigned int get_palette_size() const {
+	return (unsigned int)draw_palette.size();
+  }
+
+  // The bone id of every entry of the draw palette
+  [[nodiscard]] const std::vector<unsigned int> &get_draw_palette() const {
+	return draw_palette;
+  }
+
+  // Writes the draw palette (get_palette_size() matrices) for skinning matrices that are indexed by bone id
+  void gather_palette(const glm::mat4 *bone_matrices, glm::mat4 *out) const;
+
   void precompute_node_bone_indices() {
 	for (auto &nodeData : node_list) {
 	  auto bone = get_bone_by_name(nodeData.node_name);
@@ -99,12 +184,24 @@ class Model {
   }
 
  private:
+  std::vector<unsigned int> draw_palette{};
 
   // Loops through all bones in the bone list for a bone with the given bone_name.
   //		If such a bone exists, the bone along with its index into the bone list is returned.
   //		Otherwise, if such a bone does not exist, nullopt is returned.
   [[nodiscard]]  std::optional<std::pair<Bone, int>> get_bone_by_name(const std::string &bone_name) const;
   double update_time(double delta_time);
+
+  // Like evaluate_pose, but always samples the keyframes
+  void evaluate_keyframes(double animation_time,
+						  std::vector<glm::mat4> &out_skinning_matrices,
+						  unsigned int bone_lod) const;
+
+  // Samples & composes a single node with its parent, which must already have been evaluated
+  void evaluate_node(unsigned int node_index,
+					 double animation_time,
+					 std::vector<glm::mat4> &global_transforms,
+					 std::vector<glm::mat4> &out_skinning_matrices) const;
 };
 
 #endif //OPENGL_SKELETAL_ANIMATION_SRC_MODELS_MODEL_H_
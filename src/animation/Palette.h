@@ -0,0 +1,51 @@
+//
+// Created by tor on 10/19/26.
+//
+
+#ifndef OPENGL_SKELETAL_ANIMATION_SRC_ANIMATION_PALETTE_H_
+#define OPENGL_SKELETAL_ANIMATION_SRC_ANIMATION_PALETTE_H_
+
+#include <cstddef>
+#include <glm/glm.hpp>
+#include <glm/gtc/quaternion.hpp>
+
+// Blends a single skinning matrix from `from` towards `to`. The rotations are blended as quaternions (nlerp) & the
+// scale & translation linearly, so that the result stays a rotation even when the two poses are several ticks apart
+// (the update-rate LOD interpolates over up to update_interval ticks). A component-wise blend would shrink & shear
+// rotated bones instead. Mirrored matrices cannot be expressed as a rotation & fall back to the component-wise blend.
+inline glm::mat4 blend_skinning_matrix(const glm::mat4 &from, const glm::mat4 &to, float factor) {
+  const glm::mat3 from_basis{from};
+  const glm::mat3 to_basis{to};
+  if (glm::determinant(from_basis) <= 0.0f || glm::determinant(to_basis) <= 0.0f) {
+	return from + (to - from) * factor;
+  }
+
+  const glm::vec3 from_scale{glm::length(from_basis[0]), glm::length(from_basis[1]), glm::length(from_basis[2])};
+  const glm::vec3 to_scale{glm::length(to_basis[0]), glm::length(to_basis[1]), glm::length(to_basis[2])};
+  const glm::quat from_rotation = glm::quat_cast(glm::mat3{from_basis[0] / from_scale.x,
+														   from_basis[1] / from_scale.y,
+														   from_basis[2] / from_scale.z});
+  glm::quat to_rotation = glm::quat_cast(glm::mat3{to_basis[0] / to_scale.x,
+												   to_basis[1] / to_scale.y,
+												   to_basis[2] / to_scale.z});
+  // Takes the shorter way around
+  if (glm::dot(from_rotation, to_rotation) < 0.0f) {
+	to_rotation = -to_rotation;
+  }
+
+  const glm::mat3 rotation = glm::mat3_cast(glm::normalize(from_rotation * (1.0f - factor) + to_rotation * factor));
+  const glm::vec3 scale = from_scale + (to_scale - from_scale) * factor;
+  return glm::mat4{glm::vec4(rotation[0] * scale.x, 0.0f),
+				   glm::vec4(rotation[1] * scale.y, 0.0f),
+				   glm::vec4(rotation[2] * scale.z, 0.0f),
+				   from[3] + (to[3] - from[3]) * factor};
+}
+
+// Blends count skinning matrices from `from` towards `to`, see blend_skinning_matrix
+inline void blend_palettes(const glm::mat4 *from, const glm::mat4 *to, float factor, glm::mat4 *out, size_t count) {
+  for (size_t i = 0; i < count; i++) {
+	out[i] = blend_skinning_matrix(from[i], to[i], factor);
+  }
+}
+
+#endif //OPENGL_SKELETAL_ANIMATION_SRC_ANIMATION_PALETTE_H_
@@ -0,0 +1,104 @@
+//
+// Created by tor on 10/19/26.
+//
+
+#include <cmath>
+#include <functional>
+#include "PoseCache.h"
+
+PoseCache::PoseCache(double time_step, size_t memory_cap_bytes)
+	: time_step(time_step), memory_cap_bytes(memory_cap_bytes) {}
+
+size_t PoseCache::KeyHash::operator()(const Key &key) const {
+  size_t hash = std::hash<const Model *>()(key.model);
+  hash ^= std::hash<int64_t>()(key.time_bucket) + 0x9e3779b9 + (hash << 6) + (hash >> 2);
+  hash ^= std::hash<unsigned int>()(key.bone_lod) + 0x9e3779b9 + (hash << 6) + (hash >> 2);
+  return hash;
+}
+
+void PoseCache::evaluate(const Model &model,
+						 double animation_time,
+						 unsigned int bone_lod,
+						 std::vector<glm::mat4> &out_skinning_matrices) {
+  // Animation time is measured in ticks, while the step is given in seconds
+  double ticks_per_second = model.ticks_per_second > 0.0 ? model.ticks_per_second : 1.0;
+  double step = time_step * ticks_per_second;
+  auto bucket_count = std::max((int64_t)std::ceil(model.animation_duration / step), (int64_t)1);
+  int64_t bucket = std::llround(animation_time / step) % bucket_count;
+  double quantized_time = (double)bucket * step;
+
+  // The error wraps around since the last bucket rounds up to the first one
+  double time_error = std::abs(animation_time - quantized_time);
+  time_error = std::min(time_error, std::abs(model.animation_duration - time_error)) / ticks_per_second;
+  stats.total_time_error += time_error;
+  stats.max_time_error = std::max(stats.max_time_error, time_error);
+
+  const auto bone_count = (size_t)model.get_bone_count();
+  Key key{&model, bone_lod, bucket};
+  auto cached = lookup.find(key);
+  if (cached != lookup.end()) {
+	stats.hits++;
+	// Moves the entry to the front of the list, since it is now the most recently used
+	entries.splice(entries.begin(), entries, cached->second);
+	const auto &cached_matrices = cached->second->skinning_matrices;
+	std::copy(cached_matrices.begin(), cached_matrices.end(), out_skinning_matrices.begin());
+
+	if (stats.hits % ERROR_SAMPLE_INTERVAL == 0) {
+	  measure_palette_error(model, animation_time, bone_lod, cached_matrices);
+	}
+	return;
+  }
+
+  stats.misses++;
+  model.evaluate_pose(quantized_time, out_skinning_matrices, bone_lod);
+
+  entries.push_front({key, std::vector<glm::mat4>(out_skinning_matrices.begin(),
+												  out_skinning_matrices.begin() + (long)bone_count)});
+  lookup[key] = entries.begin();
+  stats.memory_bytes += get_entry_size(entries.front());
+
+  while (stats.memory_bytes > memory_cap_bytes && !entries.empty()) {
+	stats.memory_bytes -= get_entry_size(entries.back());
+	lookup.erase(entries.back().key);
+	entries.pop_back();
+	stats.evictions++;
+  }
+  stats.entry_count = entries.size();
+}
+
+void PoseCache::clear() {
+  entries.clear();
+  lookup.clear();
+  stats.entry_count = 0;
+  stats.memory_bytes = 0;
+}
+
+void PoseCache::reset_stats() {
+  auto entry_count = stats.entry_count;
+  auto memory_bytes = stats.memory_bytes;
+  stats = {};
+  stats.entry_count = entry_count;
+  stats.memory_bytes = memory_bytes;
+}
+
+size_t PoseCache::get_entry_size(const Entry &entry) {
+  // The palette itself, plus the list node and the lookup table entry that point to it
+  return entry.skinning_matrices.size() * sizeof(glm::mat4) + sizeof(Entry) + sizeof(Key) + 4 * sizeof(void *);
+}
+
+void PoseCache::measure_palette_error(const Model &model,
+									  double animation_time,
+									  unsigned int bone_lod,
+									  const std::vector<glm::mat4> &cached_skinning_matrices) {
+  exact_skinning_matrices.resize(model.skinning_matrices.size(), glm::mat4(1.0f));
+  model.evaluate_pose(animation_time, exact_skinning_matrices, bone_lod);
+
+  for (size_t bone = 0; bone < cached_skinning_matrices.size(); bone++) {
+	for (int column = 0; column < 4; column++) {
+	  for (int row = 0; row < 4; row++) {
+		float error = std::abs(exact_skinning_matrices[bone][column][row] - cached_skinning_matrices[bone][column][row]);
+		stats.max_palette_error = std::max(stats.max_palette_error, error);
+	  }
+	}
+  }
+}
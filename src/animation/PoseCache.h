@@ -0,0 +1,104 @@
+//
+// Created by tor on 10/19/26.
+//
+
+#ifndef OPENGL_SKELETAL_ANIMATION_SRC_ANIMATION_POSECACHE_H_
+#define OPENGL_SKELETAL_ANIMATION_SRC_ANIMATION_POSECACHE_H_
+
+#include <cstdint>
+#include <list>
+#include <unordered_map>
+#include <vector>
+#include <glm/glm.hpp>
+#include "Model.h"
+
+struct PoseCacheStats {
+  uint64_t hits = 0;
+  uint64_t misses = 0;
+  uint64_t evictions = 0;
+  size_t entry_count = 0;
+  size_t memory_bytes = 0;
+
+  // Difference (in seconds) between the requested animation time and the quantized time that was evaluated
+  double total_time_error = 0.0;
+  double max_time_error = 0.0;
+  // Largest difference of any skinning matrix element between a cached palette and the exact palette, only
+  // measured for a sample of the hits since computing the exact palette defeats the purpose of the cache
+  float max_palette_error = 0.0f;
+
+  [[nodiscard]] double get_hit_rate() const {
+	return hits + misses > 0 ? (double)hits / (double)(hits + misses) : 0.0;
+  }
+
+  [[nodiscard]] double get_mean_time_error() const {
+	return hits + misses > 0 ? total_time_error / (double)(hits + misses) : 0.0;
+  }
+};
+
+// Shares evaluated skinning matrices between instances that play the same clip at (almost) the same time.
+// Animation time is quantized to time_step, every instance that falls within the same step reuses the palette
+// evaluated at the center of that step. Least recently used palettes are evicted to stay within the memory cap.
+class PoseCache {
+ public:
+  /**
+   * @param time_step Quantization step in seconds, larger steps give more hits but a less accurate pose.
+   * @param memory_cap_bytes The maximum memory used by the cached palettes.
+   */
+  PoseCache(double time_step, size_t memory_cap_bytes);
+
+  // Writes the skinning matrices of model at animation_time to out_skinning_matrices, either from the cache or
+  // by evaluating (and caching) the pose at the quantized time.
+  void evaluate(const Model &model,
+				double animation_time,
+				unsigned int bone_lod,
+				std::vector<glm::mat4> &out_skinning_matrices);
+
+  void clear();
+
+  [[nodiscard]] const PoseCacheStats &get_stats() const {
+	return stats;
+  }
+
+  // Resets the counters & errors, the entries and the memory use are kept
+  void reset_stats();
+
+ private:
+  // Every n:th hit is compared against the exact pose to measure the error introduced by the quantization
+  static constexpr uint64_t ERROR_SAMPLE_INTERVAL = 64;
+
+  struct Key {
+	const Model *model;
+	unsigned int bone_lod;
+	int64_t time_bucket;
+
+	bool operator==(const Key &other) const {
+	  return model == other.model && bone_lod == other.bone_lod && time_bucket == other.time_bucket;
+	}
+  };
+
+  struct KeyHash {
+	size_t operator()(const Key &key) const;
+  };
+
+  struct Entry {
+	Key key;
+	std::vector<glm::mat4> skinning_matrices;
+  };
+
+  double time_step;
+  size_t memory_cap_bytes;
+  PoseCacheStats stats{};
+
+  // Most recently used entries first
+  std::list<Entry> entries{};
+  std::unordered_map<Key, std::list<Entry>::iterator, KeyHash> lookup{};
+  std::vector<glm::mat4> exact_skinning_matrices{};
+
+  [[nodiscard]] static size_t get_entry_size(const Entry &entry);
+  void measure_palette_error(const Model &model,
+							 double animation_time,
+							 unsigned int bone_lod,
+							 const std::vector<glm::mat4> &cached_skinning_matrices);
+};
+
+#endif //OPENGL_SKELETAL_ANIMATION_SRC_ANIMATION_POSECACHE_H_
@@ -0,0 +1,31 @@
+//
+// Created by tor on 10/19/26.
+//
+
+#include <algorithm>
+#include <utility>
+#include "UpdateRateLod.h"
+
+UpdateRateLod::UpdateRateLod(std::vector<UpdateRateTier> tiers, SkippedFrameMode mode)
+	: tiers(std::move(tiers)), skipped_frame_mode(mode) {
+  std::sort(this->tiers.begin(), this->tiers.end(), [](const auto &a, const auto &b) {
+	return a.min_screen_size > b.min_screen_size;
+  });
+}
+
+unsigned int UpdateRateLod::select_update_interval(float screen_size) const {
+  if (tiers.empty()) {
+	return 1;
+  }
+
+  for (const auto &tier : tiers) {
+	if (screen_size >= tier.min_screen_size) {
+	  return std::max(tier.update_interval, 1u);
+	}
+  }
+  // The smallest tier does not necessarily have the largest interval, tiers may be given in any order
+  auto largest = std::max_element(tiers.begin(), tiers.end(), [](const auto &a, const auto &b) {
+	return a.update_interval < b.update_interval;
+  });
+  return std::max(largest->update_interval, 1u);
+}
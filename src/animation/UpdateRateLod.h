@@ -0,0 +1,45 @@
+//
+// Created by tor on 10/19/26.
+//
+
+#ifndef OPENGL_SKELETAL_ANIMATION_SRC_ANIMATION_UPDATERATELOD_H_
+#define OPENGL_SKELETAL_ANIMATION_SRC_ANIMATION_UPDATERATELOD_H_
+
+#include <vector>
+
+// How an instance is drawn during the animation ticks where its pose is not evaluated
+enum class SkippedFrameMode {
+  // Keep drawing the most recently evaluated skinning matrices
+  REUSE_LAST_PALETTE,
+  // Blend between the two most recently evaluated skinning matrices. This is smooth, but the displayed pose
+  // lags behind by one update interval.
+  INTERPOLATE_PALETTES
+};
+
+struct UpdateRateTier {
+  // Instances with an approximate screen size (bounding radius / distance) of at least this use the tier
+  float min_screen_size;
+  // The pose is evaluated every update_interval ticks (1 = every tick, 2 = every other tick, ...)
+  unsigned int update_interval;
+};
+
+// Selects how often an instance's pose is evaluated from how large the instance appears on screen.
+class UpdateRateLod {
+ public:
+  UpdateRateLod() = default;
+  // Tiers may be given in any order, an instance smaller than every tier uses the largest interval
+  UpdateRateLod(std::vector<UpdateRateTier> tiers, SkippedFrameMode mode);
+
+  [[nodiscard]] unsigned int select_update_interval(float screen_size) const;
+
+  [[nodiscard]] SkippedFrameMode get_skipped_frame_mode() const {
+	return skipped_frame_mode;
+  }
+
+ private:
+  // Sorted by min_screen_size, largest first. Empty means that every instance is updated every tick.
+  std::vector<UpdateRateTier> tiers{};
+  SkippedFrameMode skipped_frame_mode = SkippedFrameMode::REUSE_LAST_PALETTE;
+};
+
+#endif //OPENGL_SKELETAL_ANIMATION_SRC_ANIMATION_UPDATERATELOD_H_
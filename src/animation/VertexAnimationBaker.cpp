@@ -0,0 +1,166 @@
+//
+// Created by tor on 10/19/26.
+//
+
+#include <cstring>
+#include <filesystem>
+#include <fstream>
+#include <iostream>
+#include "VertexAnimationBaker.h"
+
+// Bumped whenever the file layout changes, which invalidates every cached file
+static const uint32_t FILE_VERSION = 2;
+static const char FILE_MAGIC[4] = {'V', 'A', 'T', 'B'};
+
+// The start of a cache file, followed by the positions
+struct VertexAnimationHeader {
+  char magic[4];
+  uint32_t version;
+  uint32_t frame_count;
+  uint32_t vertex_count;
+  double frame_rate;
+  double duration;
+  uint64_t source_hash;
+};
+
+// FNV-1a, which is plenty for telling bakes apart
+static void hash_bytes(uint64_t &hash, const void *data, size_t size) {
+  const auto *bytes = (const unsigned char *)data;
+  for (size_t i = 0; i < size; i++) {
+	hash = (hash ^ bytes[i]) * 1099511628211ull;
+  }
+}
+
+VertexAnimation VertexAnimationBaker::bake(const Model &model, double frame_rate, CpuSkinner &skinner) {
+  const BakedPalettes baked = model.create_baked_palettes(frame_rate);
+  const double ticks_per_second = model.ticks_per_second > 0.0 ? model.ticks_per_second : 1.0;
+
+  VertexAnimation animation{};
+  animation.frame_rate = frame_rate;
+  animation.duration = model.animation_duration / ticks_per_second;
+  animation.frame_count = baked.frame_count;
+  animation.vertex_count = get_vertex_count(model);
+  animation.source_hash = get_source_hash(model);
+  animation.positions.resize((size_t)animation.frame_count * animation.vertex_count);
+
+  std::vector<glm::mat4> palette(model.get_palette_size());
+  for (unsigned int frame = 0; frame < baked.frame_count; frame++) {
+	model.gather_palette(baked.skinning_matrices.data() + (size_t)frame * baked.bone_count, palette.data());
+	auto *out = animation.positions.data() + (size_t)frame * animation.vertex_count;
+	for (const auto &mesh : model.mesh_list) {
+	  skinner.skin(mesh.vertices, palette.data() + mesh.palette_offset, mesh.bone_palette.size(), out);
+	  out += mesh.vertices.size();
+	}
+  }
+  return animation;
+}
+
+bool VertexAnimationBaker::save(const VertexAnimation &animation, const std::string &path) {
+  std::ofstream stream(path, std::ios::binary | std::ios::trunc);
+  if (!stream) {
+	std::cerr << "VertexAnimationBaker::Error - Could not open " << path << " for writing\n";
+	return false;
+  }
+
+  VertexAnimationHeader header{};
+  std::memcpy(header.magic, FILE_MAGIC, sizeof(FILE_MAGIC));
+  header.version = FILE_VERSION;
+  header.frame_count = animation.frame_count;
+  header.vertex_count = animation.vertex_count;
+  header.frame_rate = animation.frame_rate;
+  header.duration = animation.duration;
+  header.source_hash = animation.source_hash;
+  stream.write((const char *)&header, sizeof(header));
+  stream.write((const char *)animation.positions.data(), (std::streamsize)animation.get_memory_usage());
+  if (!stream) {
+	std::cerr << "VertexAnimationBaker::Error - Could not write " << path << "\n";
+	return false;
+  }
+  return true;
+}
+
+std::optional<VertexAnimation> VertexAnimationBaker::load(const std::string &path) {
+  std::ifstream stream(path, std::ios::binary);
+  if (!stream) {
+	return std::nullopt;
+  }
+
+  VertexAnimationHeader header{};
+  stream.read((char *)&header, sizeof(header));
+  if (!stream || std::memcmp(header.magic, FILE_MAGIC, sizeof(FILE_MAGIC)) != 0 || header.version != FILE_VERSION) {
+	return std::nullopt;
+  }
+
+  VertexAnimation animation{};
+  animation.frame_rate = header.frame_rate;
+  animation.duration = header.duration;
+  animation.frame_count = header.frame_count;
+  animation.vertex_count = header.vertex_count;
+  animation.source_hash = header.source_hash;
+  animation.positions.resize((size_t)header.frame_count * header.vertex_count);
+  stream.read((char *)animation.positions.data(), (std::streamsize)animation.get_memory_usage());
+  if (!stream) {
+	return std::nullopt;
+  }
+  return animation;
+}
+
+VertexAnimation VertexAnimationBaker::load_or_bake(const Model &model,
+												   const std::string &model_path,
+												   const std::string &animation_path,
+												   double frame_rate,
+												   CpuSkinner &skinner) {
+  namespace fs = std::filesystem;
+  const std::string cache_path = get_cache_path(model_path, animation_path);
+
+  // A cache written before either asset was last modified may no longer match them
+  std::error_code error;
+  const auto cache_time = fs::last_write_time(cache_path, error);
+  const bool up_to_date = !error && fs::last_write_time(model_path, error) <= cache_time && !error
+	  && fs::last_write_time(animation_path, error) <= cache_time && !error;
+  if (up_to_date) {
+	auto cached = load(cache_path);
+	if (cached && cached->frame_rate == frame_rate && cached->vertex_count == get_vertex_count(model)
+		&& cached->source_hash == get_source_hash(model)) {
+	  return std::move(*cached);
+	}
+  }
+
+  VertexAnimation animation = bake(model, frame_rate, skinner);
+  save(animation, cache_path);
+  return animation;
+}
+
+std::string VertexAnimationBaker::get_cache_path(const std::string &model_path, const std::string &animation_path) {
+  const std::filesystem::path animation(animation_path);
+  const std::string file_name =
+	  std::filesystem::path(model_path).stem().string() + "." + animation.stem().string() + ".vat";
+  return (animation.parent_path() / file_name).string();
+}
+
+uint64_t VertexAnimationBaker::get_source_hash(const Model &model) {
+  uint64_t hash = 14695981039346656037ull;
+  for (const auto &mesh : model.mesh_list) {
+	// Every member of a vertex is 4 bytes wide, so there is no padding to hash
+	hash_bytes(hash, mesh.vertices.data(), mesh.vertices.size() * sizeof(AnimatedVertex));
+	hash_bytes(hash, mesh.bone_palette.data(), mesh.bone_palette.size() * sizeof(unsigned int));
+	hash_bytes(hash, &mesh.palette_offset, sizeof(mesh.palette_offset));
+  }
+  hash_bytes(hash, model.bone_offset_matrix.data(), model.bone_offset_matrix.size() * sizeof(glm::mat4));
+  for (const auto &node : model.node_list) {
+	hash_bytes(hash, &node.transformation, sizeof(node.transformation));
+	hash_bytes(hash, &node.bone_index, sizeof(node.bone_index));
+	hash_bytes(hash, &node.parent_index, sizeof(node.parent_index));
+  }
+  hash_bytes(hash, &model.animation_duration, sizeof(model.animation_duration));
+  hash_bytes(hash, &model.ticks_per_second, sizeof(model.ticks_per_second));
+  return hash;
+}
+
+unsigned int VertexAnimationBaker::get_vertex_count(const Model &model) {
+  size_t vertex_count = 0;
+  for (const auto &mesh : model.mesh_list) {
+	vertex_count += mesh.vertices.size();
+  }
+  return (unsigned int)vertex_count;
+}
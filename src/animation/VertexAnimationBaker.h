@@ -0,0 +1,74 @@
+//
+// Created by tor on 10/19/26.
+//
+
+#ifndef OPENGL_SKELETAL_ANIMATION_SRC_ANIMATION_VERTEXANIMATIONBAKER_H_
+#define OPENGL_SKELETAL_ANIMATION_SRC_ANIMATION_VERTEXANIMATIONBAKER_H_
+
+#include <cstdint>
+#include <optional>
+#include <string>
+#include <vector>
+#include <glm/glm.hpp>
+#include "CpuSkinner.h"
+#include "Model.h"
+
+// The skinned position of every vertex of a model at a fixed rate throughout its clip
+struct VertexAnimation {
+  // Frames per second of animation
+  double frame_rate = 0.0;
+  // In seconds
+  double duration = 0.0;
+  unsigned int frame_count = 0;
+  // The vertices of every mesh of the model, in mesh order
+  unsigned int vertex_count = 0;
+  // frame_count frames of vertex_count model space positions each, stored one frame after another
+  std::vector<glm::vec3> positions{};
+  // Identifies the model data that was baked, see VertexAnimationBaker::get_source_hash
+  uint64_t source_hash = 0;
+
+  [[nodiscard]] size_t get_memory_usage() const {
+	return positions.size() * sizeof(glm::vec3);
+  }
+};
+
+/**
+ * Bakes the fully skinned vertex positions of a model, so that characters far enough away that their skeleton does
+ * not matter can be drawn without any skinning at all, see VertexAnimationTexture. Baking is done headless on the
+ * CPU, from the model's baked palettes.
+ */
+class VertexAnimationBaker {
+ public:
+  // Skins every mesh of the model at frame_rate frames per second of animation
+  [[nodiscard]] static VertexAnimation bake(const Model &model, double frame_rate, CpuSkinner &skinner);
+
+  // Writes the vertex animation to the given file, returns false if it could not be written
+  static bool save(const VertexAnimation &animation, const std::string &path);
+
+  // Reads a vertex animation written by save, returns nullopt if the file is missing or invalid
+  [[nodiscard]] static std::optional<VertexAnimation> load(const std::string &path);
+
+  /**
+   * Loads the vertex animation from the cache file next to the animation asset, or bakes & caches it when the
+   * cache is missing, older than the model or animation file, or was baked from different data (frame rate or
+   * source hash).
+   */
+  [[nodiscard]] static VertexAnimation load_or_bake(const Model &model,
+													const std::string &model_path,
+													const std::string &animation_path,
+													double frame_rate,
+													CpuSkinner &skinner);
+
+  // The cache file of a model playing an animation asset, next to the animation, e.g. character.fbx playing
+  // run.fbx is cached in character.run.vat
+  [[nodiscard]] static std::string get_cache_path(const std::string &model_path, const std::string &animation_path);
+
+  // Hashes the data the bake depends on: the vertices & local palettes of every mesh, the bone offsets & the node
+  // hierarchy. A loader or optimizer change that reorders vertices gives a different hash.
+  [[nodiscard]] static uint64_t get_source_hash(const Model &model);
+
+  // The number of vertices of every mesh of the model
+  [[nodiscard]] static unsigned int get_vertex_count(const Model &model);
+};
+
+#endif //OPENGL_SKELETAL_ANIMATION_SRC_ANIMATION_VERTEXANIMATIONBAKER_H_
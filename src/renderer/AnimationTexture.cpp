@@ -0,0 +1,86 @@
+//
+// Created by tor on 10/19/26.
+//
+
+#include <algorithm>
+#include <cmath>
+#include <stdexcept>
+#include <string>
+#include "AnimationTexture.h"
+
+// The clips are preceded by the playback time, like in the AnimationClips shader storage block
+struct AnimationClipsHeader {
+  float time;
+  unsigned int padding[3];
+};
+
+AnimationTexture::AnimationTexture(const std::vector<Model *> &models, double frame_rate) {
+  std::vector<BakedPalettes> baked_clips;
+  baked_clips.reserve(models.size());
+  unsigned int palette_size = 0;
+  for (auto *model : models) {
+	const auto &baked = baked_clips.emplace_back(model->create_baked_palettes(frame_rate));
+	const double ticks_per_second = model->ticks_per_second > 0.0 ? model->ticks_per_second : 1.0;
+
+	model->animation_texture_clip = (int)clips.size();
+	clips.push_back({(unsigned int)height, baked.frame_count, (float)(ticks_per_second / baked.frame_length),
+					 (float)(baked.animation_duration / ticks_per_second)});
+	height += (int)baked.frame_count;
+	palette_size = std::max(palette_size, model->get_palette_size());
+  }
+  width = (int)std::max(palette_size, 1u) * 3;
+  height = std::max(height, 1);
+  // The texture could not be allocated, & the crowd would be drawn from garbage
+  int max_texture_size = 0;
+  glGetIntegerv(GL_MAX_TEXTURE_SIZE, &max_texture_size);
+  if (width > max_texture_size || height > max_texture_size) {
+	throw std::runtime_error("AnimationTexture::Error - A " + std::to_string(width) + " x " + std::to_string(height)
+								 + " texture exceeds GL_MAX_TEXTURE_SIZE (" + std::to_string(max_texture_size)
+								 + "), lower the frame rate or bake fewer clips or bones");
+  }
+
+  // Keeps the top 3 rows of every skinning matrix, the bottom row of an affine transform is always (0, 0, 0, 1)
+  std::vector<glm::vec4> texels((size_t)width * height, glm::vec4(0.0f));
+  std::vector<glm::mat4> palette;
+  for (size_t clip = 0; clip < clips.size(); clip++) {
+	const auto &baked = baked_clips[clip];
+	palette.resize(models[clip]->get_palette_size());
+	for (unsigned int frame = 0; frame < baked.frame_count; frame++) {
+	  // Every row holds the draw palette, so that the meshes can index it with their local bone ids
+	  models[clip]->gather_palette(baked.skinning_matrices.data() + (size_t)frame * baked.bone_count, palette.data());
+	  auto *row = &texels[(size_t)(clips[clip].first_frame + frame) * width];
+	  for (size_t entry = 0; entry < palette.size(); entry++) {
+		const auto &matrix = palette[entry];
+		for (int i = 0; i < 3; i++) {
+		  row[entry * 3 + i] = glm::vec4(matrix[0][i], matrix[1][i], matrix[2][i], matrix[3][i]);
+		}
+	  }
+	}
+  }
+
+  glCreateTextures(GL_TEXTURE_2D, 1, &texture_id);
+  glTextureStorage2D(texture_id, 1, GL_RGBA32F, width, height);
+  glTextureSubImage2D(texture_id, 0, 0, 0, width, height, GL_RGBA, GL_FLOAT, texels.data());
+  // Only ever read with texelFetch
+  glTextureParameteri(texture_id, GL_TEXTURE_MIN_FILTER, GL_NEAREST);
+  glTextureParameteri(texture_id, GL_TEXTURE_MAG_FILTER, GL_NEAREST);
+
+  glCreateBuffers(1, &clip_buffer_id);
+  glNamedBufferStorage(clip_buffer_id, (long)(sizeof(AnimationClipsHeader) + clips.size() * sizeof(AnimationClip)),
+					   nullptr, GL_DYNAMIC_STORAGE_BIT);
+  glNamedBufferSubData(clip_buffer_id, sizeof(AnimationClipsHeader), (long)(clips.size() * sizeof(AnimationClip)),
+					   clips.data());
+}
+
+AnimationTexture::~AnimationTexture() {
+  glDeleteTextures(1, &texture_id);
+  glDeleteBuffers(1, &clip_buffer_id);
+}
+
+void AnimationTexture::bind(double time) const {
+  // Wrapping the time to a day keeps enough float precision for the frames
+  AnimationClipsHeader header{(float)std::fmod(time, 86400.0), {}};
+  glNamedBufferSubData(clip_buffer_id, 0, sizeof(header), &header);
+  glBindTextureUnit(TEXTURE_UNIT, texture_id);
+  glBindBufferBase(GL_SHADER_STORAGE_BUFFER, CLIPS_BINDING, clip_buffer_id);
+}
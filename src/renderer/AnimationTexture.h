@@ -0,0 +1,69 @@
+//
+// Created by tor on 10/19/26.
+//
+
+#ifndef OPENGL_SKELETAL_ANIMATION_SRC_RENDERER_ANIMATIONTEXTURE_H_
+#define OPENGL_SKELETAL_ANIMATION_SRC_RENDERER_ANIMATIONTEXTURE_H_
+
+#include <vector>
+#include <glad/glad.h>
+#include <glm/glm.hpp>
+#include "animation/Model.h"
+
+// Matches AnimationClip in skeletal_animation_instanced.vert.glsl (std430 layout)
+struct AnimationClip {
+  // The texture row of the clip's first frame
+  unsigned int first_frame;
+  unsigned int frame_count;
+  float frames_per_second;
+  // In seconds
+  float duration;
+};
+
+/**
+ * The baked clips of several models in a single texture, so that the vertex shader can compute the pose of an
+ * instance from its clip & time alone, without any animation on the CPU or palette uploads. Every row of the
+ * texture holds one frame of a clip, with 3 RGBA32F texels per entry of the model's draw palette (see
+ * Model::gather_palette) that are the rows of its (3x4) skinning matrix. The clips are stacked on top of each other.
+ * Drawn by Renderer::render_instances with SkinningMode::ANIMATION_TEXTURE.
+ */
+class AnimationTexture {
+ public:
+  // The texture unit & shader storage binding that the vertex shader reads the texture & clips from
+  static constexpr unsigned int TEXTURE_UNIT = 1;
+  static constexpr unsigned int CLIPS_BINDING = 6;
+
+  /**
+   * Bakes the animation of every model at frame_rate frames per second, by sampling the keyframes of its bones,
+   * & sets each model's animation_texture_clip. Throws std::runtime_error if the texture would exceed
+   * GL_MAX_TEXTURE_SIZE, i.e. the largest draw palette is too wide or the clips have too many frames altogether.
+   */
+  AnimationTexture(const std::vector<Model *> &models, double frame_rate);
+  ~AnimationTexture();
+  AnimationTexture(const AnimationTexture &) = delete;
+  AnimationTexture &operator=(const AnimationTexture &) = delete;
+
+  // Binds the texture & the clips for drawing, every instance is posed at time (in seconds) plus its own offset
+  void bind(double time) const;
+
+  [[nodiscard]] unsigned int get_texture_id() const {
+	return texture_id;
+  }
+
+  [[nodiscard]] const std::vector<AnimationClip> &get_clips() const {
+	return clips;
+  }
+
+  [[nodiscard]] size_t get_memory_usage() const {
+	return (size_t)width * height * sizeof(glm::vec4);
+  }
+
+ private:
+  std::vector<AnimationClip> clips{};
+  unsigned int texture_id{};
+  unsigned int clip_buffer_id{};
+  int width = 0;
+  int height = 0;
+};
+
+#endif //OPENGL_SKELETAL_ANIMATION_SRC_RENDERER_ANIMATIONTEXTURE_H_
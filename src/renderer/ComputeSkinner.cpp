@@ -0,0 +1,159 @@
+//
+// Created by tor on 10/19/26.
+//
+
+#include <algorithm>
+#include <map>
+#include "ComputeSkinner.h"
+
+// skinning.comp.glsl reads & writes the vertices as tightly packed 32 bit values
+static_assert(sizeof(AnimatedVertex) == 13 * sizeof(float), "AnimatedVertex does not match VERTEX_STRIDE");
+static_assert(sizeof(PackedAnimatedVertex) == 5 * sizeof(uint32_t),
+			  "PackedAnimatedVertex does not match PACKED_VERTEX_STRIDE");
+static_assert(sizeof(SkinnedVertex) == 5 * sizeof(float), "SkinnedVertex does not match SKINNED_VERTEX_STRIDE");
+
+ComputeSkinner::ComputeSkinner(const MeshArena &mesh_arena, const std::string &compute_shader_path)
+	: mesh_arena(mesh_arena), compute_shader(compute_shader_path.c_str()) {
+  compute_shader.use();
+  compute_shader.setBool("packed_vertices", mesh_arena.get_vertex_format() == VertexFormat::PACKED);
+  int max_work_group_count_y = 0;
+  glGetIntegeri_v(GL_MAX_COMPUTE_WORK_GROUP_COUNT, 1, &max_work_group_count_y);
+  max_job_groups_y = (unsigned int)std::max(max_work_group_count_y, 1);
+
+  glCreateVertexArrays(1, &vao);
+
+  // Vertex Positions
+  glEnableVertexArrayAttrib(vao, 0);
+  glVertexArrayAttribFormat(vao, 0, 3, GL_FLOAT, GL_FALSE, offsetof(SkinnedVertex, pos));
+  glVertexArrayAttribBinding(vao, 0, 0);
+
+  // Texture coordinates
+  glEnableVertexArrayAttrib(vao, 1);
+  glVertexArrayAttribFormat(vao, 1, 2, GL_FLOAT, GL_FALSE, offsetof(SkinnedVertex, tex_coords));
+  glVertexArrayAttribBinding(vao, 1, 0);
+}
+
+ComputeSkinner::~ComputeSkinner() {
+  glDeleteVertexArrays(1, &vao);
+  glDeleteBuffers(1, &output_buffer_id);
+}
+
+void ComputeSkinner::skin(const std::vector<AnimationInstance> &instances, RingBuffer &ring_buffer) {
+  size_t palette_count = 0;
+  size_t job_count = 0;
+  size_t vertex_count = 0;
+  unsigned int max_job_vertex_count = 0;
+  for (const auto &instance : instances) {
+	// Baked instances are drawn by their StaticPoseCache
+	if (instance.static_pose) {
+	  continue;
+	}
+	palette_count += instance.model->get_palette_size();
+	job_count += instance.model->mesh_list.size();
+	for (const auto &mesh : instance.model->mesh_list) {
+	  vertex_count += mesh.allocation->vertex_count;
+	  max_job_vertex_count = std::max(max_job_vertex_count, mesh.allocation->vertex_count);
+	}
+  }
+  draw_batches.clear();
+  skinned_vertex_count = 0;
+  if (job_count == 0) {
+	return;
+  }
+
+  auto palettes = ring_buffer.allocate(palette_count * sizeof(glm::mat4), ring_buffer.get_storage_alignment());
+  auto jobs = ring_buffer.allocate(job_count * sizeof(SkinningJob), ring_buffer.get_storage_alignment());
+  auto commands = ring_buffer.allocate(job_count * sizeof(DrawElementsIndirectCommand),
+									   alignof(DrawElementsIndirectCommand));
+  if (!palettes || !jobs || !commands) {
+	std::cerr << "ComputeSkinner::Error - The ring buffer is too small for " << instances.size() << " instances\n";
+	return;
+  }
+  reserve_output(vertex_count);
+
+  // The draw commands are grouped by texture & index size, so that each is drawn with a single multi-draw call
+  std::map<std::pair<unsigned int, unsigned int>, std::vector<DrawElementsIndirectCommand>> batch_commands_map;
+  auto *palette_output = (glm::mat4 *)palettes->data;
+  auto *job_output = (SkinningJob *)jobs->data;
+  unsigned int palette_offset = 0;
+  unsigned int output_vertex = 0;
+  for (const auto &instance : instances) {
+	if (instance.static_pose) {
+	  continue;
+	}
+	instance.write_render_skinning_matrices(palette_output + palette_offset);
+
+	for (const auto &mesh : instance.model->mesh_list) {
+	  const auto &allocation = *mesh.allocation;
+	  *job_output++ = SkinningJob{instance.model_matrix, glm::vec4(allocation.position_scale, 0.0f),
+								  glm::vec4(allocation.position_offset, 0.0f), allocation.base_vertex,
+								  allocation.vertex_count, palette_offset + mesh.palette_offset, output_vertex};
+	  // The skinned vertices are indexed with the mesh's own indices, only the base vertex differs
+	  batch_commands_map[{instance.model->texture_id.value_or(0), allocation.index_size}].push_back(
+		  {allocation.index_count, 1, allocation.first_index, (int)output_vertex, 0});
+	  output_vertex += allocation.vertex_count;
+	}
+	palette_offset += instance.model->get_palette_size();
+  }
+  skinned_vertex_count = output_vertex;
+
+  auto *command_output = (DrawElementsIndirectCommand *)commands->data;
+  size_t command_offset = commands->offset;
+  for (const auto &[batch_key, batch_commands] : batch_commands_map) {
+	std::copy(batch_commands.begin(), batch_commands.end(), command_output);
+	command_output += batch_commands.size();
+	draw_batches.push_back({batch_key.first, get_index_type(batch_key.second), command_offset,
+							(unsigned int)batch_commands.size()});
+	command_offset += batch_commands.size() * sizeof(DrawElementsIndirectCommand);
+  }
+
+  compute_shader.use();
+  ring_buffer.bind_range(GL_SHADER_STORAGE_BUFFER, SKINNING_MATRICES_BINDING, *palettes);
+  ring_buffer.bind_range(GL_SHADER_STORAGE_BUFFER, JOBS_BINDING, *jobs);
+  glBindBufferBase(GL_SHADER_STORAGE_BUFFER, SOURCE_VERTICES_BINDING, mesh_arena.get_vertex_arena().get_buffer_id());
+  glBindBufferBase(GL_SHADER_STORAGE_BUFFER, SKINNED_VERTICES_BINDING, output_buffer_id);
+  compute_shader.setInt("job_count", (int)job_count);
+  const auto job_groups_y = (unsigned int)std::min<size_t>(job_count, max_job_groups_y);
+  const auto job_groups_z = (unsigned int)((job_count + job_groups_y - 1) / job_groups_y);
+  glDispatchCompute((max_job_vertex_count + WORKGROUP_SIZE - 1) / WORKGROUP_SIZE, job_groups_y, job_groups_z);
+
+  // The output is read as vertex attributes by every pass, and may be read back for validation
+  glMemoryBarrier(GL_VERTEX_ATTRIB_ARRAY_BARRIER_BIT | GL_BUFFER_UPDATE_BARRIER_BIT | GL_SHADER_STORAGE_BARRIER_BIT);
+}
+
+void ComputeSkinner::render(const RingBuffer &ring_buffer) const {
+  if (draw_batches.empty()) {
+	return;
+  }
+
+  // The index buffer is replaced when the arena grows, so it is attached again every time
+  glVertexArrayVertexBuffer(vao, 0, output_buffer_id, 0, sizeof(SkinnedVertex));
+  glVertexArrayElementBuffer(vao, mesh_arena.get_index_arena().get_buffer_id());
+  glBindVertexArray(vao);
+  glBindBuffer(GL_DRAW_INDIRECT_BUFFER, ring_buffer.get_buffer_id());
+
+  for (const auto &batch : draw_batches) {
+	if (batch.texture_id) {
+	  glActiveTexture(GL_TEXTURE0);
+	  glBindTexture(GL_TEXTURE_2D, batch.texture_id);
+	}
+	glMultiDrawElementsIndirect(GL_TRIANGLES, batch.index_type, (void *)batch.command_offset,
+								(int)batch.command_count, 0);
+	Renderer::draw_call_count++;
+  }
+
+  glBindBuffer(GL_DRAW_INDIRECT_BUFFER, 0);
+  glBindVertexArray(0);
+}
+
+void ComputeSkinner::reserve_output(size_t vertex_count) {
+  if (vertex_count <= output_capacity) {
+	return;
+  }
+
+  // The output is rewritten every frame, so nothing has to be copied to the new buffer
+  output_capacity = std::max(vertex_count, output_capacity * 2);
+  glDeleteBuffers(1, &output_buffer_id);
+  glCreateBuffers(1, &output_buffer_id);
+  glNamedBufferStorage(output_buffer_id, (long)(output_capacity * sizeof(SkinnedVertex)), nullptr, 0);
+}
@@ -0,0 +1,95 @@
+//
+// Created by tor on 10/19/26.
+//
+
+#ifndef OPENGL_SKELETAL_ANIMATION_SRC_RENDERER_COMPUTESKINNER_H_
+#define OPENGL_SKELETAL_ANIMATION_SRC_RENDERER_COMPUTESKINNER_H_
+
+#include <string>
+#include <vector>
+#include <glad/glad.h>
+#include <glm/glm.hpp>
+#include "animation/AnimationInstance.h"
+#include "shader/Shader.h"
+#include "MeshArena.h"
+#include "Renderer.h"
+#include "RingBuffer.h"
+
+// Matches SkinningJob in skinning.comp.glsl (std430 layout)
+struct SkinningJob {
+  glm::mat4 model_matrix;
+  glm::vec4 position_scale;
+  glm::vec4 position_offset;
+  unsigned int source_vertex;
+  unsigned int vertex_count;
+  unsigned int palette_offset;
+  unsigned int output_vertex;
+};
+
+// A skinned vertex as written by skinning.comp.glsl
+struct SkinnedVertex {
+  glm::vec3 pos;
+  glm::vec2 tex_coords;
+};
+
+// Skins every mesh of every instance once per frame with skinning.comp.glsl, which reads either vertex format.
+// The skinned vertices are written in world space to a buffer that any number of passes (shadows, depth prepass,
+// picking, ...) can then draw as static geometry with static_mesh.vert.glsl, rather than skinning every vertex
+// again in each pass.
+// NOTE: The vertex format has no normals, so only positions are skinned.
+class ComputeSkinner {
+ public:
+  // Binding points of the shader storage blocks in skinning.comp.glsl, the palettes use SKINNING_MATRICES_BINDING
+  static const unsigned int SOURCE_VERTICES_BINDING = 2;
+  static const unsigned int JOBS_BINDING = 3;
+  static const unsigned int SKINNED_VERTICES_BINDING = 4;
+  static const unsigned int WORKGROUP_SIZE = 64;
+
+  ComputeSkinner(const MeshArena &mesh_arena, const std::string &compute_shader_path);
+  ~ComputeSkinner();
+  ComputeSkinner(const ComputeSkinner &) = delete;
+  ComputeSkinner &operator=(const ComputeSkinner &) = delete;
+
+  /**
+   * Skins all instances into the output buffer. The palettes, jobs & draw commands are written into the current
+   * region of the ring buffer. The skinned vertices are laid out in the order of the instances, then of their
+   * meshes. Leaves the compute shader in use.
+   */
+  void skin(const std::vector<AnimationInstance> &instances, RingBuffer &ring_buffer);
+
+  // Draws everything that was skinned by the last call to skin(), static_mesh.vert.glsl must be in use
+  void render(const RingBuffer &ring_buffer) const;
+
+  [[nodiscard]] unsigned int get_output_buffer_id() const {
+	return output_buffer_id;
+  }
+
+  // The number of vertices written by the last call to skin()
+  [[nodiscard]] size_t get_skinned_vertex_count() const {
+	return skinned_vertex_count;
+  }
+
+ private:
+  // The draw commands of meshes that share a texture & an index type, stored in the ring buffer
+  struct DrawBatch {
+	unsigned int texture_id;
+	unsigned int index_type;
+	size_t command_offset;
+	unsigned int command_count;
+  };
+
+  // Grows the output buffer so that it holds at least vertex_count vertices
+  void reserve_output(size_t vertex_count);
+
+  const MeshArena &mesh_arena;
+  Shader compute_shader;
+  unsigned int vao{};
+  // GL_MAX_COMPUTE_WORK_GROUP_COUNT in y, the jobs that do not fit are folded into z
+  unsigned int max_job_groups_y{};
+  unsigned int output_buffer_id{};
+  size_t output_capacity = 0;
+  size_t skinned_vertex_count = 0;
+  std::vector<DrawBatch> draw_batches{};
+};
+
+#endif //OPENGL_SKELETAL_ANIMATION_SRC_RENDERER_COMPUTESKINNER_H_
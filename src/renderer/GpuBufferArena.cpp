@@ -0,0 +1,129 @@
+//
+// Created by tor on 10/19/26.
+//
+
+#include <algorithm>
+#include "GpuBufferArena.h"
+
+GpuBufferArena::GpuBufferArena(size_t element_size, size_t initial_capacity)
+	: element_size(element_size), capacity(std::max<size_t>(initial_capacity, 1)) {
+  glCreateBuffers(1, &buffer_id);
+  glNamedBufferStorage(buffer_id, (long)(capacity * element_size), nullptr, GL_DYNAMIC_STORAGE_BIT);
+  free_ranges[0] = capacity;
+}
+
+GpuBufferArena::~GpuBufferArena() {
+  glDeleteBuffers(1, &buffer_id);
+}
+
+size_t GpuBufferArena::allocate(size_t count) {
+  count = std::max<size_t>(count, 1);
+
+  auto range = std::find_if(free_ranges.begin(), free_ranges.end(), [count](const auto &free_range) {
+	return free_range.second >= count;
+  });
+  if (range == free_ranges.end()) {
+	// Doubles the capacity so that loading many meshes only reallocates a logarithmic number of times
+	const size_t old_capacity = capacity;
+	const size_t new_capacity = std::max(capacity * 2, capacity + count);
+	reallocate(new_capacity, {{0, 0, old_capacity}});
+
+	// The new space is merged with a free range that ends at the old capacity
+	size_t free_start = old_capacity;
+	if (!free_ranges.empty()) {
+	  auto last = std::prev(free_ranges.end());
+	  if (last->first + last->second == old_capacity) {
+		free_start = last->first;
+		free_ranges.erase(last);
+	  }
+	}
+	free_ranges[free_start] = new_capacity - free_start;
+	range = free_ranges.find(free_start);
+  }
+
+  const size_t offset = range->first;
+  const size_t remaining = range->second - count;
+  free_ranges.erase(range);
+  if (remaining > 0) {
+	free_ranges[offset + count] = remaining;
+  }
+
+  live_ranges[offset] = count;
+  used_count += count;
+  return offset;
+}
+
+void GpuBufferArena::free(size_t offset) {
+  auto live_range = live_ranges.find(offset);
+  if (live_range == live_ranges.end()) {
+	return;
+  }
+  size_t start = offset;
+  size_t size = live_range->second;
+  used_count -= size;
+  live_ranges.erase(live_range);
+
+  // Merges with the free ranges directly after and before this one
+  auto next = free_ranges.find(start + size);
+  if (next != free_ranges.end()) {
+	size += next->second;
+	free_ranges.erase(next);
+  }
+  auto previous = free_ranges.lower_bound(start);
+  if (previous != free_ranges.begin()) {
+	previous = std::prev(previous);
+	if (previous->first + previous->second == start) {
+	  start = previous->first;
+	  size += previous->second;
+	  free_ranges.erase(previous);
+	}
+  }
+  free_ranges[start] = size;
+}
+
+void GpuBufferArena::upload(size_t offset, const void *data, size_t count) const {
+  glNamedBufferSubData(buffer_id, (long)(offset * element_size), (long)(count * element_size), data);
+}
+
+std::vector<std::pair<size_t, size_t>> GpuBufferArena::defragment() {
+  std::vector<std::pair<size_t, size_t>> moved;
+  std::vector<Copy> copies;
+  std::map<size_t, size_t> packed_ranges;
+
+  size_t next_offset = 0;
+  for (const auto &[offset, size] : live_ranges) {
+	copies.push_back({offset, next_offset, size});
+	if (offset != next_offset) {
+	  moved.emplace_back(offset, next_offset);
+	}
+	packed_ranges[next_offset] = size;
+	next_offset += size;
+  }
+  if (moved.empty()) {
+	return moved;
+  }
+
+  // Copying into a fresh buffer avoids overlapping source & destination ranges
+  reallocate(capacity, copies);
+  live_ranges = std::move(packed_ranges);
+  free_ranges.clear();
+  if (next_offset < capacity) {
+	free_ranges[next_offset] = capacity - next_offset;
+  }
+  return moved;
+}
+
+void GpuBufferArena::reallocate(size_t new_capacity, const std::vector<Copy> &copies) {
+  unsigned int new_buffer_id;
+  glCreateBuffers(1, &new_buffer_id);
+  glNamedBufferStorage(new_buffer_id, (long)(new_capacity * element_size), nullptr, GL_DYNAMIC_STORAGE_BIT);
+  for (const auto &copy : copies) {
+	glCopyNamedBufferSubData(buffer_id, new_buffer_id,
+							 (long)(copy.source_offset * element_size),
+							 (long)(copy.destination_offset * element_size),
+							 (long)(copy.count * element_size));
+  }
+  glDeleteBuffers(1, &buffer_id);
+  buffer_id = new_buffer_id;
+  capacity = new_capacity;
+}
@@ -0,0 +1,78 @@
+//
+// Created by tor on 10/19/26.
+//
+
+#ifndef OPENGL_SKELETAL_ANIMATION_SRC_RENDERER_GPUBUFFERARENA_H_
+#define OPENGL_SKELETAL_ANIMATION_SRC_RENDERER_GPUBUFFERARENA_H_
+
+#include <cstddef>
+#include <map>
+#include <utility>
+#include <vector>
+#include <glad/glad.h>
+
+// Suballocates ranges of fixed-size elements (vertices, indices, ...) out of a single GPU buffer. Offsets & sizes
+// are counted in elements, so an offset can be used directly as a base vertex or first index.
+// Freed ranges are merged with their free neighbours and reused first-fit. The buffer grows when no free range is
+// large enough, and defragment() packs the live ranges at the start of the buffer. Both replace the buffer, so
+// get_buffer_id() has to be re-bound afterwards.
+class GpuBufferArena {
+ public:
+  GpuBufferArena(size_t element_size, size_t initial_capacity);
+  ~GpuBufferArena();
+  GpuBufferArena(const GpuBufferArena &) = delete;
+  GpuBufferArena &operator=(const GpuBufferArena &) = delete;
+
+  // Reserves count elements and returns the offset of the first one, growing the buffer if needed
+  [[nodiscard]] size_t allocate(size_t count);
+
+  // Returns the range starting at offset to the free list
+  void free(size_t offset);
+
+  // Writes count elements to the buffer, starting at offset
+  void upload(size_t offset, const void *data, size_t count) const;
+
+  /**
+   * Moves every live range to the start of the buffer, leaving a single free range at the end.
+   * @return The (old offset, new offset) of every range that moved.
+   */
+  std::vector<std::pair<size_t, size_t>> defragment();
+
+  [[nodiscard]] unsigned int get_buffer_id() const {
+	return buffer_id;
+  }
+
+  [[nodiscard]] size_t get_capacity() const {
+	return capacity;
+  }
+
+  // The number of elements in live ranges
+  [[nodiscard]] size_t get_used_count() const {
+	return used_count;
+  }
+
+  // More than one free range means that the free space is fragmented
+  [[nodiscard]] size_t get_free_range_count() const {
+	return free_ranges.size();
+  }
+
+ private:
+  struct Copy {
+	size_t source_offset;
+	size_t destination_offset;
+	size_t count;
+  };
+
+  // Replaces the buffer with one that holds new_capacity elements, copying the given ranges over
+  void reallocate(size_t new_capacity, const std::vector<Copy> &copies);
+
+  size_t element_size;
+  size_t capacity;
+  size_t used_count = 0;
+  unsigned int buffer_id{};
+  // Both map an offset to the size of the range that starts there
+  std::map<size_t, size_t> live_ranges{};
+  std::map<size_t, size_t> free_ranges{};
+};
+
+#endif //OPENGL_SKELETAL_ANIMATION_SRC_RENDERER_GPUBUFFERARENA_H_
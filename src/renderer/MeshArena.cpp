@@ -0,0 +1,139 @@
+//
+// Created by tor on 10/19/26.
+//
+
+#include <algorithm>
+#include <optional>
+#include <unordered_map>
+#include "MeshArena.h"
+
+static const unsigned int VERTEX_BINDING = 0;
+
+// The index arena counts in 16 bit units, every allocation is an even number of them so that the offsets are aligned
+// for 32 bit indices as well
+static size_t get_index_arena_offset(const MeshAllocation &allocation) {
+  return allocation.first_index * allocation.index_size / sizeof(uint16_t);
+}
+
+MeshArena::MeshArena(VertexFormat vertex_format, size_t initial_vertex_capacity, size_t initial_index_capacity)
+	: vertex_format(vertex_format),
+	  vertex_arena(get_vertex_size(vertex_format), initial_vertex_capacity),
+	  index_arena(sizeof(uint16_t), initial_index_capacity + initial_index_capacity % 2) {
+  glCreateVertexArrays(1, &vao);
+  for (unsigned int attribute = 0; attribute < 4; attribute++) {
+	glEnableVertexArrayAttrib(vao, attribute);
+	glVertexArrayAttribBinding(vao, attribute, VERTEX_BINDING);
+  }
+
+  if (vertex_format == VertexFormat::PACKED) {
+	// Vertex Positions, normalized to the mesh's bounding box
+	glVertexArrayAttribFormat(vao, 0, 3, GL_UNSIGNED_SHORT, GL_TRUE, offsetof(PackedAnimatedVertex, pos));
+	// Texture coordinates
+	glVertexArrayAttribFormat(vao, 1, 2, GL_HALF_FLOAT, GL_FALSE, offsetof(PackedAnimatedVertex, tex_coords));
+	// Bone IDs that affect this mesh's vertices
+	glVertexArrayAttribIFormat(vao, 2, 4, GL_UNSIGNED_BYTE, offsetof(PackedAnimatedVertex, bone_ids));
+	// Bone weights that affect this mesh's vertices
+	glVertexArrayAttribFormat(vao, 3, 4, GL_UNSIGNED_BYTE, GL_TRUE, offsetof(PackedAnimatedVertex, bone_weights));
+  } else {
+	// Vertex Positions
+	glVertexArrayAttribFormat(vao, 0, 3, GL_FLOAT, GL_FALSE, offsetof(AnimatedVertex, pos));
+	// Texture coordinates
+	glVertexArrayAttribFormat(vao, 1, 2, GL_FLOAT, GL_FALSE, offsetof(AnimatedVertex, tex_coords));
+	// Bone IDs that affect this mesh's vertices
+	glVertexArrayAttribIFormat(vao, 2, 4, GL_INT, offsetof(AnimatedVertex, bone_ids));
+	// Bone weights that affect this mesh's vertices
+	glVertexArrayAttribFormat(vao, 3, 4, GL_FLOAT, GL_FALSE, offsetof(AnimatedVertex, bone_weights));
+  }
+
+  // Advances once per instance & respects the draw's base instance, the buffer is attached by the renderer
+  glEnableVertexArrayAttrib(vao, DRAW_INDEX_ATTRIBUTE);
+  glVertexArrayAttribIFormat(vao, DRAW_INDEX_ATTRIBUTE, 2, GL_UNSIGNED_INT, 0);
+  glVertexArrayAttribBinding(vao, DRAW_INDEX_ATTRIBUTE, DRAW_INDEX_BINDING);
+  glVertexArrayBindingDivisor(vao, DRAW_INDEX_BINDING, 1);
+
+  bind_buffers();
+}
+
+MeshArena::~MeshArena() {
+  glDeleteVertexArrays(1, &vao);
+}
+
+void MeshArena::add_model(Model &model) {
+  for (auto &mesh : model.mesh_list) {
+	auto allocation = std::make_shared<MeshAllocation>();
+	allocation->vertex_count = (unsigned int)mesh.vertices.size();
+	allocation->index_count = (unsigned int)mesh.indices.size();
+	allocation->index_size = get_index_size(mesh.vertices.size());
+
+	// Packing may fail, so it happens before anything is allocated
+	std::optional<PackedVertices> packed;
+	if (vertex_format == VertexFormat::PACKED) {
+	  packed = pack_vertices(mesh.vertices);
+	  allocation->position_scale = packed->position_scale;
+	  allocation->position_offset = packed->position_offset;
+	}
+
+	allocation->base_vertex = (unsigned int)vertex_arena.allocate(mesh.vertices.size());
+	const size_t index_units = mesh.indices.size() * allocation->index_size / sizeof(uint16_t);
+	const size_t index_offset = index_arena.allocate(index_units + index_units % 2);
+	allocation->first_index = (unsigned int)(index_offset * sizeof(uint16_t) / allocation->index_size);
+	if (packed) {
+	  vertex_arena.upload(allocation->base_vertex, packed->vertices.data(), packed->vertices.size());
+	} else {
+	  vertex_arena.upload(allocation->base_vertex, mesh.vertices.data(), mesh.vertices.size());
+	}
+	if (allocation->index_size == sizeof(uint16_t)) {
+	  std::vector<uint16_t> short_indices(mesh.indices.begin(), mesh.indices.end());
+	  index_arena.upload(index_offset, short_indices.data(), short_indices.size());
+	} else {
+	  index_arena.upload(index_offset, mesh.indices.data(), index_units);
+	}
+
+	mesh.allocation = allocation;
+	allocations.push_back(std::move(allocation));
+  }
+  model.vao = vao;
+  bind_buffers();
+}
+
+void MeshArena::remove_model(Model &model) {
+  for (auto &mesh : model.mesh_list) {
+	if (!mesh.allocation) {
+	  continue;
+	}
+	vertex_arena.free(mesh.allocation->base_vertex);
+	index_arena.free(get_index_arena_offset(*mesh.allocation));
+	allocations.erase(std::remove(allocations.begin(), allocations.end(), mesh.allocation), allocations.end());
+	mesh.allocation.reset();
+  }
+  model.vao = 0;
+}
+
+void MeshArena::defragment() {
+  std::unordered_map<size_t, size_t> moved_vertices, moved_indices;
+  for (const auto &[old_offset, new_offset] : vertex_arena.defragment()) {
+	moved_vertices[old_offset] = new_offset;
+  }
+  for (const auto &[old_offset, new_offset] : index_arena.defragment()) {
+	moved_indices[old_offset] = new_offset;
+  }
+  if (moved_vertices.empty() && moved_indices.empty()) {
+	return;
+  }
+
+  for (auto &allocation : allocations) {
+	if (auto moved = moved_vertices.find(allocation->base_vertex); moved != moved_vertices.end()) {
+	  allocation->base_vertex = (unsigned int)moved->second;
+	}
+	if (auto moved = moved_indices.find(get_index_arena_offset(*allocation)); moved != moved_indices.end()) {
+	  allocation->first_index = (unsigned int)(moved->second * sizeof(uint16_t) / allocation->index_size);
+	}
+  }
+  bind_buffers();
+}
+
+void MeshArena::bind_buffers() const {
+  glVertexArrayVertexBuffer(vao, VERTEX_BINDING, vertex_arena.get_buffer_id(), 0,
+							(int)get_vertex_size(vertex_format));
+  glVertexArrayElementBuffer(vao, index_arena.get_buffer_id());
+}
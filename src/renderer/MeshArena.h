@@ -0,0 +1,75 @@
+//
+// Created by tor on 10/19/26.
+//
+
+#ifndef OPENGL_SKELETAL_ANIMATION_SRC_RENDERER_MESHARENA_H_
+#define OPENGL_SKELETAL_ANIMATION_SRC_RENDERER_MESHARENA_H_
+
+#include <memory>
+#include <vector>
+#include <glad/glad.h>
+#include "animation/Model.h"
+#include "GpuBufferArena.h"
+#include "VertexFormat.h"
+
+// Packs the vertices & indices of every skinned mesh into one shared vertex buffer and one shared index buffer,
+// which are drawn through a single VAO. Each mesh only keeps its offsets (see MeshAllocation), so meshes of
+// different models can be drawn by the same multi-draw call. Every vertex is stored in the arena's VertexFormat,
+// the VAO's attributes decode either format into the same shader inputs.
+// Meshes with few enough vertices store 16 bit indices (see get_index_size), both sizes share the index buffer.
+class MeshArena {
+ public:
+  // The binding & attribute that provide the indices into the per-instance & per-mesh data, see
+  // Renderer::render_instances
+  static constexpr unsigned int DRAW_INDEX_BINDING = 1;
+  static constexpr unsigned int DRAW_INDEX_ATTRIBUTE = 4;
+
+  // The index capacity is counted in 16 bit indices
+  explicit MeshArena(VertexFormat vertex_format = VertexFormat::FULL,
+					 size_t initial_vertex_capacity = 1 << 16,
+					 size_t initial_index_capacity = 1 << 18);
+  ~MeshArena();
+  MeshArena(const MeshArena &) = delete;
+  MeshArena &operator=(const MeshArena &) = delete;
+
+  /**
+   * Uploads every mesh of the model & makes the model draw from the arena's VAO.
+   * @throws std::runtime_error if the vertices are packed & a bone id does not fit in a PackedAnimatedVertex.
+   */
+  void add_model(Model &model);
+
+  // Frees the model's meshes, the space is reused by models that are added later
+  void remove_model(Model &model);
+
+  // Packs the live meshes at the start of both buffers & updates their allocations
+  void defragment();
+
+  [[nodiscard]] VertexFormat get_vertex_format() const {
+	return vertex_format;
+  }
+
+  [[nodiscard]] unsigned int get_vao() const {
+	return vao;
+  }
+
+  [[nodiscard]] const GpuBufferArena &get_vertex_arena() const {
+	return vertex_arena;
+  }
+
+  [[nodiscard]] const GpuBufferArena &get_index_arena() const {
+	return index_arena;
+  }
+
+ private:
+  // Attaches the current vertex & index buffers to the VAO, they are replaced whenever an arena grows or
+  // is defragmented
+  void bind_buffers() const;
+
+  VertexFormat vertex_format;
+  GpuBufferArena vertex_arena;
+  GpuBufferArena index_arena;
+  std::vector<std::shared_ptr<MeshAllocation>> allocations{};
+  unsigned int vao{};
+};
+
+#endif //OPENGL_SKELETAL_ANIMATION_SRC_RENDERER_MESHARENA_H_
@@ -0,0 +1,89 @@
+//
+// Created by tor on 10/19/26.
+//
+
+#include <algorithm>
+#include <cstring>
+#include "PaletteBuffer.h"
+
+PaletteBuffer::~PaletteBuffer() {
+  glDeleteBuffers(1, &buffer_id);
+}
+
+void PaletteBuffer::upload(const std::vector<AnimationInstance> &instances, SkinningMode skinning_mode) {
+  const size_t mode_entry_size =
+	  skinning_mode == SkinningMode::DUAL_QUATERNION ? sizeof(DualQuaternion) : sizeof(glm::mat4);
+
+  // The previous palettes can only be compared against if every instance's palette is still in the same place
+  std::vector<unsigned int> offsets;
+  offsets.reserve(instances.size());
+  unsigned int entry_count = 0;
+  for (const auto &instance : instances) {
+	offsets.push_back(entry_count);
+	entry_count += instance.model->get_palette_size();
+  }
+  const bool full_upload = mode_entry_size != entry_size || offsets != palette_offsets;
+  entry_size = mode_entry_size;
+  palette_offsets = std::move(offsets);
+
+  current_palettes.resize(entry_count * entry_size);
+  for (size_t i = 0; i < instances.size(); i++) {
+	auto *out = current_palettes.data() + palette_offsets[i] * entry_size;
+	if (skinning_mode == SkinningMode::DUAL_QUATERNION) {
+	  instances[i].write_render_dual_quaternions((DualQuaternion *)out);
+	} else {
+	  instances[i].write_render_skinning_matrices((glm::mat4 *)out);
+	}
+  }
+
+  uploaded_bytes = 0;
+  uploaded_range_count = 0;
+  if (full_upload) {
+	reserve(current_palettes.size());
+  }
+  auto is_changed = [&](size_t entry) {
+	return full_upload || std::memcmp(&current_palettes[entry * entry_size],
+									  &uploaded_palettes[entry * entry_size],
+									  entry_size) != 0;
+  };
+
+  size_t entry = 0;
+  while (entry < entry_count) {
+	if (!is_changed(entry)) {
+	  entry++;
+	  continue;
+	}
+	// Extends the range over short runs of unchanged bones, up to the last changed one
+	size_t range_end = entry + 1;
+	size_t next = range_end;
+	while (next < entry_count && next - range_end < MERGE_DISTANCE) {
+	  if (is_changed(next)) {
+		range_end = next + 1;
+	  }
+	  next++;
+	}
+
+	const size_t offset = entry * entry_size;
+	const size_t size = (range_end - entry) * entry_size;
+	glNamedBufferSubData(buffer_id, (long)offset, (long)size, current_palettes.data() + offset);
+	uploaded_bytes += size;
+	uploaded_range_count++;
+	entry = range_end;
+  }
+  std::swap(uploaded_palettes, current_palettes);
+}
+
+void PaletteBuffer::bind(unsigned int binding) const {
+  glBindBufferBase(GL_SHADER_STORAGE_BUFFER, binding, buffer_id);
+}
+
+void PaletteBuffer::reserve(size_t size) {
+  if (size <= capacity && buffer_id) {
+	return;
+  }
+  glDeleteBuffers(1, &buffer_id);
+  // Grows geometrically, so that a slowly growing crowd does not recreate the buffer every frame
+  capacity = std::max(size, capacity * 2);
+  glCreateBuffers(1, &buffer_id);
+  glNamedBufferStorage(buffer_id, (long)std::max(capacity, (size_t)1), nullptr, GL_DYNAMIC_STORAGE_BIT);
+}
@@ -0,0 +1,83 @@
+//
+// Created by tor on 10/19/26.
+//
+
+#ifndef OPENGL_SKELETAL_ANIMATION_SRC_RENDERER_PALETTEBUFFER_H_
+#define OPENGL_SKELETAL_ANIMATION_SRC_RENDERER_PALETTEBUFFER_H_
+
+#include <cstddef>
+#include <vector>
+#include <glad/glad.h>
+#include "animation/AnimationInstance.h"
+#include "Renderer.h"
+
+/**
+ * Keeps the palette of every instance in a GPU buffer across frames, and only uploads the bones whose transform
+ * changed since the previous upload. Worth it when large parts of the skeletons hold still from one frame to the
+ * next, e.g. bones frozen by bone LOD, upper-body only animations or instances that are not updated every frame.
+ * Changed bones are uploaded in contiguous ranges with glNamedBufferSubData, which the driver keeps from
+ * overwriting data that earlier frames still read.
+ * The interpolated palettes that AnimationScheduler::interpolate produces change every frame for every bone that
+ * moves, so with render-time interpolation the savings only come from the bones that hold still.
+ * Pass it to Renderer::render_instances in place of writing the palettes into the ring buffer.
+ */
+class PaletteBuffer {
+ public:
+  // Changed bones that are at most this many unchanged bones apart are uploaded in the same range, since every
+  // range is a call of its own
+  static const size_t MERGE_DISTANCE = 4;
+
+  PaletteBuffer() = default;
+  ~PaletteBuffer();
+  PaletteBuffer(const PaletteBuffer &) = delete;
+  PaletteBuffer &operator=(const PaletteBuffer &) = delete;
+
+  /**
+   * Writes the palettes that the instances are drawn with this frame & uploads the bones that differ from the
+   * previous upload. Everything is uploaded when the instances or the skinning mode changed since then.
+   */
+  void upload(const std::vector<AnimationInstance> &instances, SkinningMode skinning_mode);
+
+  // Binds the palettes of every instance to the given shader storage binding
+  void bind(unsigned int binding) const;
+
+  [[nodiscard]] unsigned int get_buffer_id() const {
+	return buffer_id;
+  }
+
+  // The index of the instance's first palette entry in the buffer, in the order the instances were uploaded in
+  [[nodiscard]] unsigned int get_palette_offset(size_t instance_index) const {
+	return palette_offsets[instance_index];
+  }
+
+  // The number of bytes sent to the GPU by the last upload
+  [[nodiscard]] size_t get_uploaded_bytes() const {
+	return uploaded_bytes;
+  }
+
+  // The number of ranges (glNamedBufferSubData calls) of the last upload
+  [[nodiscard]] size_t get_uploaded_range_count() const {
+	return uploaded_range_count;
+  }
+
+  // The size of all palettes of the last upload, i.e. the bytes a full upload would have sent
+  [[nodiscard]] size_t get_palette_bytes() const {
+	return uploaded_palettes.size();
+  }
+
+ private:
+  // Recreates the buffer if the palettes no longer fit
+  void reserve(size_t size);
+
+  unsigned int buffer_id{};
+  size_t capacity = 0;
+  size_t entry_size = 0;
+  std::vector<unsigned int> palette_offsets{};
+  // The palettes as they are on the GPU, & the ones being written for the current upload
+  std::vector<unsigned char> uploaded_palettes{};
+  std::vector<unsigned char> current_palettes{};
+  size_t uploaded_bytes = 0;
+  size_t uploaded_range_count = 0;
+};
+
+#endif //OPENGL_SKELETAL_ANIMATION_SRC_RENDERER_PALETTEBUFFER_H_
@@ -2,17 +2,251 @@
 // Created by tor on 3/23/23.
 //
 
+#include <algorithm>
+#include <array>
+#include <iterator>
+#include <optional>
+#include <tuple>
 #include "Renderer.h"
+#include "ComputeSkinner.h"
+#include "PaletteBuffer.h"
 
-void Renderer::render_model(const Model &model) {
-  if (model.texture_id) {
-	glActiveTexture(GL_TEXTURE0);
-	glBindTexture(GL_TEXTURE_2D, *model.texture_id);
+size_t Renderer::get_frame_data_size(const Model &model, size_t instance_count, size_t alignment) {
+  // Either path needs a command per mesh of every instance at most, as well as the compute skinner's jobs
+  const size_t mesh_size = sizeof(MeshData) + sizeof(glm::uvec2) + sizeof(SkinningJob)
+	  + 2 * sizeof(DrawElementsIndirectCommand);
+  const size_t instance_size =
+	  model.get_palette_size() * sizeof(glm::mat4) + sizeof(InstanceData) + model.mesh_list.size() * mesh_size;
+  // Every allocation may have to be padded to the alignment
+  return instance_count * instance_size + 6 * alignment;
+}
+
+// Every influence count has a group for each index type
+static const size_t COMMAND_GROUP_COUNT = std::size(SKINNING_INFLUENCE_COUNTS) * 2;
+
+std::vector<std::string> Renderer::get_skinning_defines(unsigned int influence_count, SkinningMode skinning_mode) {
+  std::vector<std::string> defines{"MAX_INFLUENCES " + std::to_string(influence_count)};
+  if (skinning_mode == SkinningMode::DUAL_QUATERNION) {
+	defines.emplace_back("DUAL_QUATERNION_SKINNING");
+  } else if (skinning_mode == SkinningMode::ANIMATION_TEXTURE) {
+	defines.emplace_back("ANIMATION_TEXTURE");
+  } else if (skinning_mode == SkinningMode::VERTEX_ANIMATION_TEXTURE) {
+	defines.emplace_back("VERTEX_ANIMATION_TEXTURE");
+  }
+  return defines;
+}
+
+size_t Renderer::get_command_group(const Mesh &mesh) {
+  size_t variant = 0;
+  while (variant + 1 < std::size(SKINNING_INFLUENCE_COUNTS)
+	  && SKINNING_INFLUENCE_COUNTS[variant] < mesh.influence_count) {
+	variant++;
+  }
+  return variant * 2 + (mesh.allocation->index_size == sizeof(uint16_t) ? 0 : 1);
+}
+
+// The model's clip in the texture that the skinning mode reads from
+static int get_texture_clip(const Model &model, SkinningMode skinning_mode) {
+  return skinning_mode == SkinningMode::VERTEX_ANIMATION_TEXTURE ? model.vertex_animation_clip
+																 : model.animation_texture_clip;
+}
+
+// Instances can only share a draw call when they are drawn from the same VAO with the same texture
+static auto get_bucket_key(const AnimationInstance &instance) {
+  return std::make_tuple(instance.model->vao, instance.model->texture_id.value_or(0));
+}
+
+void Renderer::render_instances(const std::vector<AnimationInstance> &instances,
+								RingBuffer &ring_buffer,
+								ShaderPermutations &skinning_shaders,
+								SkinningMode skinning_mode,
+								PaletteBuffer *palette_buffer) {
+  render_instances(instances, ring_buffer, [&skinning_shaders, skinning_mode](unsigned int influence_count) {
+	skinning_shaders.get(get_skinning_defines(influence_count, skinning_mode)).use();
+  }, skinning_mode, palette_buffer);
+}
+
+void Renderer::render_instances(const std::vector<AnimationInstance> &instances,
+								RingBuffer &ring_buffer,
+								const UseSkinningShader &use_skinning_shader,
+								SkinningMode skinning_mode,
+								PaletteBuffer *palette_buffer) {
+  const bool animation_texture = skinning_mode == SkinningMode::ANIMATION_TEXTURE
+	  || skinning_mode == SkinningMode::VERTEX_ANIMATION_TEXTURE;
+  const size_t palette_entry_size =
+	  skinning_mode == SkinningMode::DUAL_QUATERNION ? sizeof(DualQuaternion) : sizeof(glm::mat4);
+  for (const auto &instance : instances) {
+	if (animation_texture && get_texture_clip(*instance.model, skinning_mode) < 0) {
+	  std::cerr << "Renderer::Error - Every model must be added to an animation texture to be drawn from one\n";
+	  return;
+	}
   }
+  // Without a palette buffer, every palette is written into the ring buffer along with the rest of the frame
+  const bool ring_buffer_palettes = !animation_texture && !palette_buffer;
+  if (palette_buffer && !animation_texture) {
+	palette_buffer->upload(instances, skinning_mode);
+	palette_buffer->bind(SKINNING_MATRICES_BINDING);
+  }
+
+  // Sorting by model as well keeps each model's instances contiguous within its bucket, the sort is stable so that
+  // the instances of a model are drawn in the order they were given
+  std::vector<const AnimationInstance *> sorted_instances;
+  sorted_instances.reserve(instances.size());
+  for (const auto &instance : instances) {
+	// Baked instances are drawn by their StaticPoseCache
+	if (instance.static_pose) {
+	  continue;
+	}
+	sorted_instances.push_back(&instance);
+  }
+  std::stable_sort(sorted_instances.begin(), sorted_instances.end(), [](const auto *a, const auto *b) {
+	const auto key_a = get_bucket_key(*a);
+	const auto key_b = get_bucket_key(*b);
+	if (key_a != key_b) {
+	  return key_a < key_b;
+	}
+	return std::less<const Model *>()(a->model, b->model);
+  });
+
+  // The indirect commands are read straight from the ring buffer
+  glBindBuffer(GL_DRAW_INDIRECT_BUFFER, ring_buffer.get_buffer_id());
+
+  size_t bucket_start = 0;
+  while (bucket_start < sorted_instances.size()) {
+	const auto bucket_key = get_bucket_key(*sorted_instances[bucket_start]);
+	size_t bucket_end = bucket_start;
+	size_t palette_count = 0;
+	size_t command_count = 0;
+	std::array<size_t, COMMAND_GROUP_COUNT> group_command_counts{};
+	size_t draw_index_count = 0;
+	while (bucket_end < sorted_instances.size() && get_bucket_key(*sorted_instances[bucket_end]) == bucket_key) {
+	  const Model *model = sorted_instances[bucket_end]->model;
+	  if (bucket_end == bucket_start || sorted_instances[bucket_end - 1]->model != model) {
+		command_count += model->mesh_list.size();
+		for (const auto &mesh : model->mesh_list) {
+		  group_command_counts[get_command_group(mesh)]++;
+		}
+	  }
+	  if (ring_buffer_palettes) {
+		palette_count += model->get_palette_size();
+	  }
+	  draw_index_count += model->mesh_list.size();
+	  bucket_end++;
+	}
+	const auto instance_count = (unsigned int)(bucket_end - bucket_start);
+
+	auto palettes = ring_buffer.allocate(palette_count * palette_entry_size, ring_buffer.get_storage_alignment());
+	auto instance_data = ring_buffer.allocate(instance_count * sizeof(InstanceData),
+											  ring_buffer.get_storage_alignment());
+	auto mesh_data = ring_buffer.allocate(command_count * sizeof(MeshData), ring_buffer.get_storage_alignment());
+	auto draw_indices = ring_buffer.allocate(draw_index_count * sizeof(glm::uvec2), alignof(glm::uvec2));
+	auto commands = ring_buffer.allocate(command_count * sizeof(DrawElementsIndirectCommand),
+										 alignof(DrawElementsIndirectCommand));
+	if (!palettes || !instance_data || !mesh_data || !draw_indices || !commands) {
+	  std::cerr << "Renderer::Error - The ring buffer is too small for " << instance_count << " instances\n";
+	  break;
+	}
+
+	auto *instance_output = (InstanceData *)instance_data->data;
+	auto *mesh_output = (MeshData *)mesh_data->data;
+	auto *draw_index_output = (glm::uvec2 *)draw_indices->data;
+	// Every command group is stored contiguously, so that it can be drawn by a call of its own
+	std::array<DrawElementsIndirectCommand *, COMMAND_GROUP_COUNT> group_command_outputs{};
+	auto *group_start = (DrawElementsIndirectCommand *)commands->data;
+	for (size_t group = 0; group < COMMAND_GROUP_COUNT; group++) {
+	  group_command_outputs[group] = group_start;
+	  group_start += group_command_counts[group];
+	}
+
+	unsigned int palette_offset = 0;
+	unsigned int model_start = 0;
+	unsigned int command_index = 0;
+	unsigned int draw_index_offset = 0;
+	for (unsigned int i = 0; i < instance_count; i++) {
+	  const auto &instance = *sorted_instances[bucket_start + i];
+	  if (animation_texture) {
+		// The clip is sampled in the vertex shader, the instance's own time offsets it from the texture's time
+		const double ticks_per_second = instance.model->ticks_per_second > 0.0 ? instance.model->ticks_per_second : 1.0;
+		instance_output[i] = InstanceData{instance.model_matrix,
+										  (unsigned int)get_texture_clip(*instance.model, skinning_mode),
+										  (float)(instance.animation_time / ticks_per_second), {}};
+	  } else if (!ring_buffer_palettes) {
+		const auto instance_index = (size_t)(sorted_instances[bucket_start + i] - instances.data());
+		instance_output[i] = InstanceData{instance.model_matrix, palette_buffer->get_palette_offset(instance_index),
+										  0.0f, {}};
+	  } else {
+		if (skinning_mode == SkinningMode::DUAL_QUATERNION) {
+		  instance.write_render_dual_quaternions((DualQuaternion *)palettes->data + palette_offset);
+		} else {
+		  instance.write_render_skinning_matrices((glm::mat4 *)palettes->data + palette_offset);
+		}
+		instance_output[i] = InstanceData{instance.model_matrix, palette_offset, 0.0f, {}};
+		palette_offset += instance.model->get_palette_size();
+	  }
+
+	  // Every mesh of a model is drawn once for each of the model's instances
+	  const bool last_of_model = i + 1 == instance_count
+		  || sorted_instances[bucket_start + i + 1]->model != instance.model;
+	  if (!last_of_model) {
+		continue;
+	  }
+	  const unsigned int model_instance_count = i + 1 - model_start;
+	  // Vertex animation textures store the vertices of all of the model's meshes one after another
+	  int mesh_first_vertex = 0;
+	  for (const auto &mesh : instance.model->mesh_list) {
+		const auto &allocation = *mesh.allocation;
+		mesh_output[command_index] = MeshData{allocation.position_scale,
+											  mesh_first_vertex - (int)allocation.base_vertex,
+											  allocation.position_offset, mesh.palette_offset};
+		mesh_first_vertex += (int)allocation.vertex_count;
+		// gl_InstanceID does not include the base instance, so the indices into the per-instance & per-mesh data
+		// are fed through an instanced attribute instead, which does
+		for (unsigned int j = 0; j < model_instance_count; j++) {
+		  *draw_index_output++ = glm::uvec2(model_start + j, command_index);
+		}
+		auto *&command_output = group_command_outputs[get_command_group(mesh)];
+		*command_output++ = DrawElementsIndirectCommand{allocation.index_count, model_instance_count,
+														allocation.first_index, (int)allocation.base_vertex,
+														draw_index_offset};
+		draw_index_offset += model_instance_count;
+		command_index++;
+	  }
+	  model_start = i + 1;
+	}
+
+	if (ring_buffer_palettes) {
+	  ring_buffer.bind_range(GL_SHADER_STORAGE_BUFFER, SKINNING_MATRICES_BINDING, *palettes);
+	}
+	ring_buffer.bind_range(GL_SHADER_STORAGE_BUFFER, INSTANCES_BINDING, *instance_data);
+	ring_buffer.bind_range(GL_SHADER_STORAGE_BUFFER, MESHES_BINDING, *mesh_data);
+
+	const auto [vao, texture_id] = bucket_key;
+	if (texture_id) {
+	  glActiveTexture(GL_TEXTURE0);
+	  glBindTexture(GL_TEXTURE_2D, texture_id);
+	}
+	glVertexArrayVertexBuffer(vao, MeshArena::DRAW_INDEX_BINDING, ring_buffer.get_buffer_id(),
+							  (long)draw_indices->offset, sizeof(glm::uvec2));
+	glBindVertexArray(vao);
+	size_t command_offset = commands->offset;
+	std::optional<unsigned int> current_influence_count;
+	for (size_t group = 0; group < COMMAND_GROUP_COUNT; group++) {
+	  if (group_command_counts[group] == 0) {
+		continue;
+	  }
+	  const unsigned int influence_count = SKINNING_INFLUENCE_COUNTS[group / 2];
+	  if (current_influence_count != influence_count) {
+		use_skinning_shader(influence_count);
+		current_influence_count = influence_count;
+	  }
+	  glMultiDrawElementsIndirect(GL_TRIANGLES, group % 2 == 0 ? GL_UNSIGNED_SHORT : GL_UNSIGNED_INT,
+								  (void *)command_offset, (int)group_command_counts[group], 0);
+	  draw_call_count++;
+	  command_offset += group_command_counts[group] * sizeof(DrawElementsIndirectCommand);
+	}
 
-  for (const auto &mesh : model.mesh_list) {
-	glBindVertexArray(mesh.vao);
-	glDrawElements(GL_TRIANGLES, (int)mesh.indices.size(), GL_UNSIGNED_INT, nullptr);
+	bucket_start = bucket_end;
   }
   glBindVertexArray(0);
+  glBindBuffer(GL_DRAW_INDIRECT_BUFFER, 0);
 }
@@ -5,14 +5,122 @@
 #ifndef OPENGL_SKELETAL_ANIMATION_SRC_RENDERER_RENDERER_H_
 #define OPENGL_SKELETAL_ANIMATION_SRC_RENDERER_RENDERER_H_
 
+#include <functional>
 #include <iostream>
+#include <string>
+#include <vector>
 #include "animation/Model.h"
+#include "animation/AnimationInstance.h"
 #include "glad/glad.h"
 #include "shader/Shader.h"
+#include "shader/ShaderPermutations.h"
+#include "MeshArena.h"
+#include "RingBuffer.h"
+
+class PaletteBuffer;
+
+// Binding point of the SkinningMatrices shader storage block in skeletal_animation_instanced.vert.glsl
+static const unsigned int SKINNING_MATRICES_BINDING = 0;
+// Binding points of the Instances & Meshes shader storage blocks in skeletal_animation_instanced.vert.glsl
+static const unsigned int INSTANCES_BINDING = 1;
+static const unsigned int MESHES_BINDING = 5;
+
+// How the vertex shader blends the bone transforms of a vertex
+enum class SkinningMode {
+  // The weighted sum of the skinning matrices, which collapses joints that twist or bend a lot
+  LINEAR_BLEND,
+  // The normalized weighted sum of dual quaternions, which preserves volume at joints. Every skinning matrix must
+  // be rigid, since only its rotation & translation are kept. Half the palette size of LINEAR_BLEND.
+  DUAL_QUATERNION,
+  // Linear blending of the skinning matrices that the vertex shader reads from the bound AnimationTexture at the
+  // instance's time, so no palettes are evaluated or uploaded. Every model must have been added to the texture.
+  ANIMATION_TEXTURE,
+  // No skinning at all, the vertex shader reads the skinned positions from the bound VertexAnimationTexture at the
+  // instance's time. Meant for distant crowds, every model must have been added to the texture.
+  VERTEX_ANIMATION_TEXTURE,
+};
+
+// The influence counts that the skinning shaders are compiled for, see Mesh::influence_count
+static const unsigned int SKINNING_INFLUENCE_COUNTS[] = {1, 2, MAX_BONE_PER_VERTEX};
+
+// Matches InstanceData in skeletal_animation_instanced.vert.glsl (std430 layout)
+struct InstanceData {
+  glm::mat4 model_matrix;
+  // The model's clip when drawing with SkinningMode::ANIMATION_TEXTURE or VERTEX_ANIMATION_TEXTURE
+  unsigned int palette_offset;
+  // Added to the animation texture's time, in seconds
+  float time_offset;
+  unsigned int padding[2];
+};
+
+// Matches MeshData in skeletal_animation_instanced.vert.glsl (std430 layout), one per draw command
+struct MeshData {
+  glm::vec3 position_scale;
+  // Added to gl_VertexID to get the vertex's index within its model's frames in a VertexAnimationTexture
+  int vertex_animation_offset;
+  glm::vec3 position_offset;
+  // Index of the mesh's local palette within its instance's palette
+  unsigned int palette_offset;
+};
+
+// Layout of a single glMultiDrawElementsIndirect command, as defined by the OpenGL specification
+struct DrawElementsIndirectCommand {
+  unsigned int count;
+  unsigned int instance_count;
+  unsigned int first_index;
+  int base_vertex;
+  unsigned int base_instance;
+};
 
 class Renderer {
  public:
-  static void render_model(const Model &model);
+  // Makes the skinning shader variant for meshes with the given influence count current
+  using UseSkinningShader = std::function<void(unsigned int influence_count)>;
+
+  /**
+   * Draws all instances with the variants of skeletal_animation_instanced.vert.glsl. Instances are bucketed by the
+   * VAO & texture they are drawn with, so models that live in the same MeshArena & share a texture are drawn
+   * together. Every bucket holds one instanced command per mesh of every model in it, which are submitted with a
+   * glMultiDrawElementsIndirect per command group (see get_command_group). The palettes, per-instance data &
+   * indirect commands are all written into the current region of the ring buffer.
+   * @param palette_buffer If given, the palettes are drawn from it instead & only the bones that changed since
+   * the previous frame are uploaded to it.
+   */
+  static void render_instances(const std::vector<AnimationInstance> &instances,
+							   RingBuffer &ring_buffer,
+							   ShaderPermutations &skinning_shaders,
+							   SkinningMode skinning_mode = SkinningMode::LINEAR_BLEND,
+							   PaletteBuffer *palette_buffer = nullptr);
+
+  // Like above, but the shader variants (which must match the skinning mode) are made current by the given
+  // function instead
+  static void render_instances(const std::vector<AnimationInstance> &instances,
+							   RingBuffer &ring_buffer,
+							   const UseSkinningShader &use_skinning_shader,
+							   SkinningMode skinning_mode = SkinningMode::LINEAR_BLEND,
+							   PaletteBuffer *palette_buffer = nullptr);
+
+  // The defines that select the skinning shader variant for meshes with the given influence count
+  [[nodiscard]] static std::vector<std::string> get_skinning_defines(
+	  unsigned int influence_count,
+	  SkinningMode skinning_mode = SkinningMode::LINEAR_BLEND);
+
+  /**
+   * A multi-draw call can only use a single shader & index type, so the commands of every bucket are drawn in
+   * groups of meshes that share both, in increasing group order. Within a group, the commands keep the order of
+   * the bucket's models & their meshes.
+   */
+  [[nodiscard]] static size_t get_command_group(const Mesh &mesh);
+
+  /**
+   * An upper bound of the ring buffer space that drawing instance_count instances of the model takes per frame,
+   * with either render_instances or ComputeSkinner::skin.
+   * @param alignment The ring buffer's storage alignment, or an upper bound of it.
+   */
+  [[nodiscard]] static size_t get_frame_data_size(const Model &model, size_t instance_count, size_t alignment = 256);
+
+  // The number of draw calls issued since the counter was last reset
+  static inline unsigned int draw_call_count = 0;
 };
 
 #endif //OPENGL_SKELETAL_ANIMATION_SRC_RENDERER_RENDERER_H_
@@ -0,0 +1,83 @@
+//
+// Created by tor on 10/19/26.
+//
+
+#include <iostream>
+#include <stdexcept>
+#include "RingBuffer.h"
+
+RingBuffer::RingBuffer(size_t region_size) {
+  GLint alignment = 0;
+  glGetIntegerv(GL_SHADER_STORAGE_BUFFER_OFFSET_ALIGNMENT, &alignment);
+  storage_alignment = alignment > 0 ? (size_t)alignment : storage_alignment;
+  // Every region starts at an offset that can be bound directly
+  this->region_size = (region_size + storage_alignment - 1) / storage_alignment * storage_alignment;
+
+  const GLbitfield flags = GL_MAP_WRITE_BIT | GL_MAP_PERSISTENT_BIT | GL_MAP_COHERENT_BIT;
+  glCreateBuffers(1, &buffer_id);
+  glNamedBufferStorage(buffer_id, (long)(this->region_size * REGION_COUNT), nullptr, flags);
+  mapped_data = (unsigned char *)glMapNamedBufferRange(buffer_id, 0, (long)(this->region_size * REGION_COUNT), flags);
+  if (mapped_data == nullptr) {
+	std::cerr << "RingBuffer::Error - Failed to persistently map the buffer\n";
+	throw std::runtime_error("Failed to map ring buffer");
+  }
+}
+
+RingBuffer::~RingBuffer() {
+  for (auto &fence : fences) {
+	if (fence != nullptr) {
+	  glDeleteSync(fence);
+	}
+  }
+  glUnmapNamedBuffer(buffer_id);
+  glDeleteBuffers(1, &buffer_id);
+}
+
+void RingBuffer::begin_frame() {
+  current_region = (current_region + 1) % REGION_COUNT;
+  region_used = 0;
+
+  auto &fence = fences[current_region];
+  if (fence == nullptr) {
+	return;
+  }
+
+  GLenum result = glClientWaitSync(fence, 0, 0);
+  if (result == GL_TIMEOUT_EXPIRED) {
+	wait_count++;
+	// Flushes the first time so that the fence is guaranteed to signal eventually
+	GLbitfield wait_flags = GL_SYNC_FLUSH_COMMANDS_BIT;
+	do {
+	  result = glClientWaitSync(fence, wait_flags, 1000000);
+	  wait_flags = 0;
+	} while (result == GL_TIMEOUT_EXPIRED);
+  }
+  if (result == GL_WAIT_FAILED) {
+	std::cerr << "RingBuffer::Error - Waiting for a fence failed\n";
+  }
+
+  glDeleteSync(fence);
+  fence = nullptr;
+}
+
+void RingBuffer::end_frame() {
+  fences[current_region] = glFenceSync(GL_SYNC_GPU_COMMANDS_COMPLETE, 0);
+}
+
+std::optional<RingBuffer::Allocation> RingBuffer::allocate(size_t size, size_t alignment) {
+  size_t offset = region_used.load();
+  size_t aligned_offset;
+  do {
+	aligned_offset = (offset + alignment - 1) / alignment * alignment;
+	if (aligned_offset + size > region_size) {
+	  return std::nullopt;
+	}
+  } while (!region_used.compare_exchange_weak(offset, aligned_offset + size));
+
+  size_t buffer_offset = current_region * region_size + aligned_offset;
+  return Allocation{mapped_data + buffer_offset, buffer_offset, size};
+}
+
+void RingBuffer::bind_range(GLenum target, unsigned int binding, const Allocation &allocation) const {
+  glBindBufferRange(target, binding, buffer_id, (long)allocation.offset, (long)allocation.size);
+}
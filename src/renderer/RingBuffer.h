@@ -0,0 +1,83 @@
+//
+// Created by tor on 10/19/26.
+//
+
+#ifndef OPENGL_SKELETAL_ANIMATION_SRC_RENDERER_RINGBUFFER_H_
+#define OPENGL_SKELETAL_ANIMATION_SRC_RENDERER_RINGBUFFER_H_
+
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+#include <optional>
+#include <glad/glad.h>
+
+// A GPU buffer that stays mapped for its whole lifetime and is split into one region per frame in flight.
+// The CPU writes the current frame's data (palettes, per-instance data, ...) straight into mapped memory while
+// the GPU still reads the regions of earlier frames. A fence per region makes sure that a region is never
+// overwritten while the GPU uses it, and the buffer is never reallocated by the driver.
+class RingBuffer {
+ public:
+  static constexpr unsigned int REGION_COUNT = 3;
+
+  struct Allocation {
+	// Points into mapped memory, anything written here is visible to the GPU without any further calls
+	void *data;
+	// Offset from the start of the buffer, e.g. for glBindBufferRange
+	size_t offset;
+	size_t size;
+  };
+
+  explicit RingBuffer(size_t region_size);
+  ~RingBuffer();
+  RingBuffer(const RingBuffer &) = delete;
+  RingBuffer &operator=(const RingBuffer &) = delete;
+
+  // Makes the next region current, waiting for the GPU if it is still reading from it
+  void begin_frame();
+
+  // Fences the current region, call this after the last draw call that reads from it
+  void end_frame();
+
+  /**
+   * Reserves size bytes in the current region. Allocating is thread-safe, so several threads may write
+   * their data into the same frame.
+   * @param alignment The allocation's offset is a multiple of this, use get_storage_alignment() for data that
+   * is bound as a shader storage buffer.
+   * @return nullopt if the region does not have enough space left.
+   */
+  [[nodiscard]] std::optional<Allocation> allocate(size_t size, size_t alignment);
+
+  // Binds an allocation to an indexed binding point (e.g. GL_SHADER_STORAGE_BUFFER)
+  void bind_range(GLenum target, unsigned int binding, const Allocation &allocation) const;
+
+  [[nodiscard]] unsigned int get_buffer_id() const {
+	return buffer_id;
+  }
+
+  [[nodiscard]] size_t get_region_size() const {
+	return region_size;
+  }
+
+  // The smallest alignment of an offset that can be bound as a shader storage buffer
+  [[nodiscard]] size_t get_storage_alignment() const {
+	return storage_alignment;
+  }
+
+  // How many times begin_frame had to wait for the GPU, which means that the CPU is more than REGION_COUNT - 1
+  // frames ahead
+  [[nodiscard]] uint64_t get_wait_count() const {
+	return wait_count;
+  }
+
+ private:
+  unsigned int buffer_id{};
+  size_t region_size;
+  size_t storage_alignment = 256;
+  unsigned char *mapped_data = nullptr;
+  unsigned int current_region = 0;
+  std::atomic<size_t> region_used{0};
+  GLsync fences[REGION_COUNT]{};
+  uint64_t wait_count = 0;
+};
+
+#endif //OPENGL_SKELETAL_ANIMATION_SRC_RENDERER_RINGBUFFER_H_
@@ -0,0 +1,158 @@
+//
+// Created by tor on 10/19/26.
+//
+
+#include <algorithm>
+#include <iostream>
+#include <map>
+#include "StaticPoseCache.h"
+
+StaticPoseCache::StaticPoseCache(const MeshArena &mesh_arena, unsigned int freeze_frames)
+	: mesh_arena(mesh_arena), freeze_frames(freeze_frames) {
+  glCreateVertexArrays(1, &vao);
+
+  // Vertex Positions
+  glEnableVertexArrayAttrib(vao, 0);
+  glVertexArrayAttribFormat(vao, 0, 3, GL_FLOAT, GL_FALSE, offsetof(SkinnedVertex, pos));
+  glVertexArrayAttribBinding(vao, 0, 0);
+
+  // Texture coordinates
+  glEnableVertexArrayAttrib(vao, 1);
+  glVertexArrayAttribFormat(vao, 1, 2, GL_FLOAT, GL_FALSE, offsetof(SkinnedVertex, tex_coords));
+  glVertexArrayAttribBinding(vao, 1, 0);
+}
+
+StaticPoseCache::~StaticPoseCache() {
+  glDeleteVertexArrays(1, &vao);
+}
+
+void StaticPoseCache::update(std::vector<AnimationInstance> &instances) {
+  if (instances.size() != states.size()) {
+	for (auto &state : states) {
+	  release(state);
+	}
+	states.assign(instances.size(), InstanceState{});
+  }
+
+  for (size_t i = 0; i < instances.size(); i++) {
+	auto &instance = instances[i];
+	auto &state = states[i];
+	const bool unchanged = state.model == instance.model && state.model_matrix == instance.model_matrix
+		&& state.pose_version == instance.pose_version
+		&& (!instance.pose_moving || state.render_blend_factor == instance.render_blend_factor);
+	if (unchanged) {
+	  state.unchanged_frames = std::min(state.unchanged_frames + 1, freeze_frames);
+	} else {
+	  release(state);
+	  state.model = instance.model;
+	  state.model_matrix = instance.model_matrix;
+	  state.pose_version = instance.pose_version;
+	  state.render_blend_factor = instance.render_blend_factor;
+	  state.unchanged_frames = 0;
+	}
+
+	if (!state.baked_vertex_offset && state.unchanged_frames >= freeze_frames) {
+	  bake(instance, state);
+	}
+	instance.static_pose = state.baked_vertex_offset.has_value();
+  }
+}
+
+void StaticPoseCache::bake(const AnimationInstance &instance, InstanceState &state) {
+  size_t vertex_count = 0;
+  for (const auto &mesh : instance.model->mesh_list) {
+	vertex_count += mesh.vertices.size();
+  }
+  if (vertex_count == 0) {
+	return;
+  }
+
+  // The same palette that the instance was drawn with, transformed straight into world space
+  palette.resize(instance.model->get_palette_size());
+  instance.write_render_skinning_matrices(palette.data());
+  skinned_positions.resize(vertex_count);
+  auto *out = skinned_positions.data();
+  for (const auto &mesh : instance.model->mesh_list) {
+	skinner.skin(mesh.vertices, palette.data() + mesh.palette_offset, mesh.bone_palette.size(), out,
+				 state.model_matrix);
+	out += mesh.vertices.size();
+  }
+
+  skinned_vertices.clear();
+  size_t vertex = 0;
+  for (const auto &mesh : instance.model->mesh_list) {
+	for (const auto &source : mesh.vertices) {
+	  skinned_vertices.push_back(SkinnedVertex{skinned_positions[vertex++], source.tex_coords});
+	}
+  }
+
+  const size_t offset = baked_vertices.allocate(vertex_count);
+  baked_vertices.upload(offset, skinned_vertices.data(), vertex_count);
+  state.baked_vertex_offset = offset;
+  baked_instance_count++;
+  bake_count++;
+}
+
+void StaticPoseCache::release(InstanceState &state) {
+  if (!state.baked_vertex_offset) {
+	return;
+  }
+  baked_vertices.free(*state.baked_vertex_offset);
+  state.baked_vertex_offset.reset();
+  baked_instance_count--;
+}
+
+void StaticPoseCache::render(RingBuffer &ring_buffer) const {
+  if (baked_instance_count == 0) {
+	return;
+  }
+
+  // Meshes that share a texture & an index type are drawn with a single multi-draw call
+  std::map<std::pair<unsigned int, unsigned int>, std::vector<DrawElementsIndirectCommand>> batch_commands_map;
+  size_t command_count = 0;
+  for (const auto &state : states) {
+	if (!state.baked_vertex_offset) {
+	  continue;
+	}
+	auto base_vertex = (int)*state.baked_vertex_offset;
+	for (const auto &mesh : state.model->mesh_list) {
+	  const auto &allocation = *mesh.allocation;
+	  batch_commands_map[{state.model->texture_id.value_or(0), allocation.index_size}].push_back(
+		  {allocation.index_count, 1, allocation.first_index, base_vertex, 0});
+	  base_vertex += (int)allocation.vertex_count;
+	  command_count++;
+	}
+  }
+
+  auto commands = ring_buffer.allocate(command_count * sizeof(DrawElementsIndirectCommand),
+									   alignof(DrawElementsIndirectCommand));
+  if (!commands) {
+	std::cerr << "StaticPoseCache::Error - The ring buffer is too small for " << baked_instance_count
+			  << " baked instances\n";
+	return;
+  }
+
+  // Either buffer is replaced when its arena grows, so they are attached again every time
+  glVertexArrayVertexBuffer(vao, 0, baked_vertices.get_buffer_id(), 0, sizeof(SkinnedVertex));
+  glVertexArrayElementBuffer(vao, mesh_arena.get_index_arena().get_buffer_id());
+  glBindVertexArray(vao);
+  glBindBuffer(GL_DRAW_INDIRECT_BUFFER, ring_buffer.get_buffer_id());
+
+  auto *command_output = (DrawElementsIndirectCommand *)commands->data;
+  size_t command_offset = commands->offset;
+  for (const auto &[batch_key, batch_commands] : batch_commands_map) {
+	std::copy(batch_commands.begin(), batch_commands.end(), command_output);
+	command_output += batch_commands.size();
+	if (batch_key.first) {
+	  glActiveTexture(GL_TEXTURE0);
+	  glBindTexture(GL_TEXTURE_2D, batch_key.first);
+	}
+	glMultiDrawElementsIndirect(GL_TRIANGLES, get_index_type(batch_key.second), (void *)command_offset,
+								(int)batch_commands.size(), 0);
+	Renderer::draw_call_count++;
+	command_offset += batch_commands.size() * sizeof(DrawElementsIndirectCommand);
+  }
+
+  glBindBuffer(GL_DRAW_INDIRECT_BUFFER, 0);
+  glBindVertexArray(0);
+}
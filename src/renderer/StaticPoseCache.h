@@ -0,0 +1,101 @@
+//
+// Created by tor on 10/19/26.
+//
+
+#ifndef OPENGL_SKELETAL_ANIMATION_SRC_RENDERER_STATICPOSECACHE_H_
+#define OPENGL_SKELETAL_ANIMATION_SRC_RENDERER_STATICPOSECACHE_H_
+
+#include <optional>
+#include <vector>
+#include <glad/glad.h>
+#include <glm/glm.hpp>
+#include "animation/AnimationInstance.h"
+#include "animation/CpuSkinner.h"
+#include "ComputeSkinner.h"
+#include "GpuBufferArena.h"
+#include "MeshArena.h"
+#include "RingBuffer.h"
+
+/**
+ * Instances that stand still (paused, props, ...) are skinned again every frame even though the result never
+ * changes. Once an instance has been drawn with the same pose & model matrix for freeze_frames frames in a row, its
+ * meshes are skinned once on the CPU into a buffer of world space vertices, & it is drawn from there with
+ * static_mesh.vert.glsl until its pose or model matrix changes again.
+ * The pose counts as unchanged while the instance's pose_version stays the same & it is not blending between two
+ * different poses, so no palette is gathered or compared until an instance is baked. Instances that keep being
+ * updated but evaluate the same pose every time (held frames, props, ...) are baked as well as paused ones.
+ * Baked instances are flagged with AnimationInstance::static_pose, which Renderer::render_instances &
+ * ComputeSkinner::skin skip.
+ * NOTE: The bake blends matrices linearly, so it must not be used together with SkinningMode::DUAL_QUATERNION, or
+ * idle instances pop to a different pose when they are baked. Instances that are animated by an (vertex) animation
+ * texture never change their pose on the CPU, so those must not be passed in either.
+ */
+class StaticPoseCache {
+ public:
+  static const unsigned int DEFAULT_FREEZE_FRAMES = 30;
+
+  explicit StaticPoseCache(const MeshArena &mesh_arena, unsigned int freeze_frames = DEFAULT_FREEZE_FRAMES);
+  ~StaticPoseCache();
+  StaticPoseCache(const StaticPoseCache &) = delete;
+  StaticPoseCache &operator=(const StaticPoseCache &) = delete;
+
+  /**
+   * Checks whether every instance's pose changed since the previous frame, bakes the instances that have been still
+   * for long enough & drops the bakes of instances that moved. Call this once per frame, after the animations are
+   * updated & interpolated, & before drawing. Everything is dropped when the number of instances changes.
+   */
+  void update(std::vector<AnimationInstance> &instances);
+
+  // Draws every baked instance, static_mesh.vert.glsl must be in use. The draw commands are written into the
+  // current region of the ring buffer.
+  void render(RingBuffer &ring_buffer) const;
+
+  // The number of instances that are currently drawn from a bake
+  [[nodiscard]] size_t get_baked_instance_count() const {
+	return baked_instance_count;
+  }
+
+  // How many times an instance has been baked, which is more than the number of baked instances if they resume
+  // & stop again
+  [[nodiscard]] size_t get_bake_count() const {
+	return bake_count;
+  }
+
+  [[nodiscard]] unsigned int get_vertex_buffer_id() const {
+	return baked_vertices.get_buffer_id();
+  }
+
+  // The first vertex of the instance's bake in the vertex buffer, nullopt if it is not baked. The vertices of its
+  // meshes are stored one after another.
+  [[nodiscard]] std::optional<size_t> get_baked_vertex_offset(size_t instance_index) const {
+	return instance_index < states.size() ? states[instance_index].baked_vertex_offset : std::nullopt;
+  }
+
+ private:
+  struct InstanceState {
+	const Model *model = nullptr;
+	glm::mat4 model_matrix{1.0f};
+	unsigned int pose_version = 0;
+	float render_blend_factor = 1.0f;
+	unsigned int unchanged_frames = 0;
+	std::optional<size_t> baked_vertex_offset = std::nullopt;
+  };
+
+  void bake(const AnimationInstance &instance, InstanceState &state);
+  void release(InstanceState &state);
+
+  const MeshArena &mesh_arena;
+  unsigned int freeze_frames;
+  CpuSkinner skinner{};
+  GpuBufferArena baked_vertices{sizeof(SkinnedVertex), 1024};
+  unsigned int vao{};
+
+  std::vector<InstanceState> states{};
+  std::vector<glm::mat4> palette{};
+  std::vector<glm::vec3> skinned_positions{};
+  std::vector<SkinnedVertex> skinned_vertices{};
+  size_t baked_instance_count = 0;
+  size_t bake_count = 0;
+};
+
+#endif //OPENGL_SKELETAL_ANIMATION_SRC_RENDERER_STATICPOSECACHE_H_
@@ -0,0 +1,69 @@
+//
+// Created by tor on 10/19/26.
+//
+
+#include <algorithm>
+#include <cmath>
+#include <stdexcept>
+#include "VertexAnimationTexture.h"
+
+// The clips are preceded by the playback time, like in the VertexAnimationClips shader storage block
+struct VertexAnimationClipsHeader {
+  float time;
+  unsigned int padding[3];
+};
+
+VertexAnimationTexture::VertexAnimationTexture(const std::vector<Model *> &models,
+											   const std::vector<VertexAnimation> &animations) {
+  if (models.size() != animations.size()) {
+	throw std::runtime_error("VertexAnimationTexture::Error - Every model needs exactly one vertex animation");
+  }
+
+  size_t texel_count = 0;
+  for (size_t i = 0; i < models.size(); i++) {
+	const auto &animation = animations[i];
+	if (animation.vertex_count != VertexAnimationBaker::get_vertex_count(*models[i])) {
+	  throw std::runtime_error("VertexAnimationTexture::Error - A vertex animation was baked from another model");
+	}
+	models[i]->vertex_animation_clip = (int)clips.size();
+	clips.push_back({(unsigned int)texel_count, animation.vertex_count, animation.frame_count,
+					 (float)animation.frame_rate, (float)animation.duration});
+	texel_count += animation.positions.size();
+  }
+  height = (int)std::max<size_t>((texel_count + TEXTURE_WIDTH - 1) / TEXTURE_WIDTH, 1);
+
+  std::vector<glm::vec4> texels((size_t)TEXTURE_WIDTH * height, glm::vec4(0.0f));
+  auto texel = texels.begin();
+  for (const auto &animation : animations) {
+	texel = std::transform(animation.positions.begin(), animation.positions.end(), texel, [](const glm::vec3 &p) {
+	  return glm::vec4(p, 1.0f);
+	});
+  }
+
+  glCreateTextures(GL_TEXTURE_2D, 1, &texture_id);
+  glTextureStorage2D(texture_id, 1, GL_RGBA32F, TEXTURE_WIDTH, height);
+  glTextureSubImage2D(texture_id, 0, 0, 0, TEXTURE_WIDTH, height, GL_RGBA, GL_FLOAT, texels.data());
+  // Only ever read with texelFetch
+  glTextureParameteri(texture_id, GL_TEXTURE_MIN_FILTER, GL_NEAREST);
+  glTextureParameteri(texture_id, GL_TEXTURE_MAG_FILTER, GL_NEAREST);
+
+  glCreateBuffers(1, &clip_buffer_id);
+  glNamedBufferStorage(clip_buffer_id,
+					   (long)(sizeof(VertexAnimationClipsHeader) + clips.size() * sizeof(VertexAnimationClip)),
+					   nullptr, GL_DYNAMIC_STORAGE_BIT);
+  glNamedBufferSubData(clip_buffer_id, sizeof(VertexAnimationClipsHeader),
+					   (long)(clips.size() * sizeof(VertexAnimationClip)), clips.data());
+}
+
+VertexAnimationTexture::~VertexAnimationTexture() {
+  glDeleteTextures(1, &texture_id);
+  glDeleteBuffers(1, &clip_buffer_id);
+}
+
+void VertexAnimationTexture::bind(double time) const {
+  // Wrapping the time to a day keeps enough float precision for the frames
+  VertexAnimationClipsHeader header{(float)std::fmod(time, 86400.0), {}};
+  glNamedBufferSubData(clip_buffer_id, 0, sizeof(header), &header);
+  glBindTextureUnit(TEXTURE_UNIT, texture_id);
+  glBindBufferBase(GL_SHADER_STORAGE_BUFFER, CLIPS_BINDING, clip_buffer_id);
+}
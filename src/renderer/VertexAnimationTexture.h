@@ -0,0 +1,68 @@
+//
+// Created by tor on 10/19/26.
+//
+
+#ifndef OPENGL_SKELETAL_ANIMATION_SRC_RENDERER_VERTEXANIMATIONTEXTURE_H_
+#define OPENGL_SKELETAL_ANIMATION_SRC_RENDERER_VERTEXANIMATIONTEXTURE_H_
+
+#include <vector>
+#include <glad/glad.h>
+#include <glm/glm.hpp>
+#include "animation/Model.h"
+#include "animation/VertexAnimationBaker.h"
+
+// Matches VertexAnimationClip in skeletal_animation_instanced.vert.glsl (std430 layout)
+struct VertexAnimationClip {
+  // The index of the clip's first texel, every frame takes vertex_count texels
+  unsigned int first_texel;
+  unsigned int vertex_count;
+  unsigned int frame_count;
+  float frames_per_second;
+  // In seconds
+  float duration;
+};
+
+/**
+ * The baked vertex animations (see VertexAnimationBaker) of several models in a single texture, so that distant
+ * characters are drawn without any skinning: the vertex shader only fetches & blends two positions per vertex.
+ * The positions of every frame of every clip are stored one after another, wrapping into rows of TEXTURE_WIDTH
+ * RGBA32F texels. Drawn by Renderer::render_instances with SkinningMode::VERTEX_ANIMATION_TEXTURE.
+ */
+class VertexAnimationTexture {
+ public:
+  // The texture unit & shader storage binding that the vertex shader reads the texture & clips from
+  static constexpr unsigned int TEXTURE_UNIT = 2;
+  static constexpr unsigned int CLIPS_BINDING = 7;
+  // Must match the row length in skeletal_animation_instanced.vert.glsl
+  static constexpr unsigned int TEXTURE_WIDTH = 4096;
+
+  // Uploads the vertex animation of every model, which must have been baked from it, & sets each model's
+  // vertex_animation_clip
+  VertexAnimationTexture(const std::vector<Model *> &models, const std::vector<VertexAnimation> &animations);
+  ~VertexAnimationTexture();
+  VertexAnimationTexture(const VertexAnimationTexture &) = delete;
+  VertexAnimationTexture &operator=(const VertexAnimationTexture &) = delete;
+
+  // Binds the texture & the clips for drawing, every instance is posed at time (in seconds) plus its own offset
+  void bind(double time) const;
+
+  [[nodiscard]] unsigned int get_texture_id() const {
+	return texture_id;
+  }
+
+  [[nodiscard]] const std::vector<VertexAnimationClip> &get_clips() const {
+	return clips;
+  }
+
+  [[nodiscard]] size_t get_memory_usage() const {
+	return (size_t)TEXTURE_WIDTH * height * sizeof(glm::vec4);
+  }
+
+ private:
+  std::vector<VertexAnimationClip> clips{};
+  unsigned int texture_id{};
+  unsigned int clip_buffer_id{};
+  int height = 0;
+};
+
+#endif //OPENGL_SKELETAL_ANIMATION_SRC_RENDERER_VERTEXANIMATIONTEXTURE_H_
@@ -0,0 +1,105 @@
+//
+// Created by tor on 10/19/26.
+//
+
+#include <algorithm>
+#include <cmath>
+#include <iostream>
+#include <numeric>
+#include <stdexcept>
+#include <glad/glad.h>
+#include <glm/gtc/packing.hpp>
+#include "VertexFormat.h"
+
+// Quantizes the weights so that they sum to exactly 255. Every weight is rounded down, then the remainder is
+// handed out to the weights that lost the most.
+static void pack_weights(const AnimatedVertex &vertex, uint8_t *out) {
+  float weights[MAX_BONE_PER_VERTEX];
+  float weight_sum = 0.0f;
+  for (int i = 0; i < MAX_BONE_PER_VERTEX; i++) {
+	weights[i] = vertex.bone_ids[i] < 0 ? 0.0f : std::max(vertex.bone_weights[i], 0.0f);
+	weight_sum += weights[i];
+  }
+  if (weight_sum <= 0.0f) {
+	std::fill(out, out + MAX_BONE_PER_VERTEX, 0);
+	return;
+  }
+
+  float remainders[MAX_BONE_PER_VERTEX];
+  int total = 0;
+  for (int i = 0; i < MAX_BONE_PER_VERTEX; i++) {
+	float scaled = weights[i] / weight_sum * 255.0f;
+	out[i] = (uint8_t)std::floor(scaled);
+	remainders[i] = scaled - (float)out[i];
+	total += out[i];
+  }
+
+  int order[MAX_BONE_PER_VERTEX];
+  std::iota(order, order + MAX_BONE_PER_VERTEX, 0);
+  std::sort(order, order + MAX_BONE_PER_VERTEX, [&](int a, int b) { return remainders[a] > remainders[b]; });
+  for (int i = 0; total < 255; i = (i + 1) % MAX_BONE_PER_VERTEX, total++) {
+	out[order[i]]++;
+  }
+}
+
+PackedVertices pack_vertices(const std::vector<AnimatedVertex> &vertices) {
+  PackedVertices result;
+  if (vertices.empty()) {
+	return result;
+  }
+
+  glm::vec3 min_position = vertices[0].pos;
+  glm::vec3 max_position = vertices[0].pos;
+  for (const auto &vertex : vertices) {
+	min_position = glm::min(min_position, vertex.pos);
+	max_position = glm::max(max_position, vertex.pos);
+  }
+  result.position_offset = min_position;
+  result.position_scale = max_position - min_position;
+  for (int axis = 0; axis < 3; axis++) {
+	// Flat meshes would otherwise divide by zero
+	if (result.position_scale[axis] <= 0.0f) {
+	  result.position_scale[axis] = 1.0f;
+	}
+  }
+
+  result.vertices.reserve(vertices.size());
+  for (const auto &vertex : vertices) {
+	PackedAnimatedVertex packed{};
+	for (int axis = 0; axis < 3; axis++) {
+	  float normalized = (vertex.pos[axis] - result.position_offset[axis]) / result.position_scale[axis];
+	  packed.pos[axis] = (uint16_t)std::lround(std::clamp(normalized, 0.0f, 1.0f) * 65535.0f);
+	}
+	packed.tex_coords[0] = glm::packHalf1x16(vertex.tex_coords.x);
+	packed.tex_coords[1] = glm::packHalf1x16(vertex.tex_coords.y);
+
+	for (int i = 0; i < MAX_BONE_PER_VERTEX; i++) {
+	  if (vertex.bone_ids[i] > MAX_PACKED_BONE_ID) {
+		std::cerr << "VertexFormat::Error - Bone id " << vertex.bone_ids[i] << " does not fit in a packed vertex\n";
+		throw std::runtime_error("Bone id does not fit in a packed vertex");
+	  }
+	  // Unused influences point at bone 0 with a weight of 0
+	  packed.bone_ids[i] = (uint8_t)std::max(vertex.bone_ids[i], 0);
+	}
+	pack_weights(vertex, packed.bone_weights);
+
+	result.vertices.push_back(packed);
+  }
+  return result;
+}
+
+size_t get_vertex_size(VertexFormat format) {
+  switch (format) {
+	case VertexFormat::FULL: return sizeof(AnimatedVertex);
+	case VertexFormat::PACKED: return sizeof(PackedAnimatedVertex);
+  }
+  return sizeof(AnimatedVertex);
+}
+
+unsigned int get_index_size(size_t vertex_count) {
+  return vertex_count <= MAX_SHORT_INDEX_VERTEX_COUNT ? sizeof(uint16_t) : sizeof(uint32_t);
+}
+
+unsigned int get_index_type(unsigned int index_size) {
+  return index_size == sizeof(uint16_t) ? GL_UNSIGNED_SHORT : GL_UNSIGNED_INT;
+}
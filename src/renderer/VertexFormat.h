@@ -0,0 +1,65 @@
+//
+// Created by tor on 10/19/26.
+//
+
+#ifndef OPENGL_SKELETAL_ANIMATION_SRC_RENDERER_VERTEXFORMAT_H_
+#define OPENGL_SKELETAL_ANIMATION_SRC_RENDERER_VERTEXFORMAT_H_
+
+#include <cstdint>
+#include <vector>
+#include <glm/glm.hpp>
+#include "animation/Model.h"
+
+// How a MeshArena stores the vertices of its meshes on the GPU
+enum class VertexFormat {
+  // AnimatedVertex as is, 52 bytes per vertex
+  FULL,
+  // PackedAnimatedVertex, 20 bytes per vertex
+  PACKED,
+};
+
+/**
+ * A compressed AnimatedVertex:
+ * - The position is quantized to unorm16 within the mesh's bounding box, see PackedVertices::position_scale.
+ * - The texture coordinates are half floats.
+ * - The bone ids are uint8, so a mesh can be influenced by at most 256 bones. Unused influences have weight 0.
+ * - The weights are unorm8 and always sum to exactly 255.
+ */
+struct PackedAnimatedVertex {
+  uint16_t pos[3];
+  uint16_t padding;
+  uint16_t tex_coords[2];
+  uint8_t bone_ids[MAX_BONE_PER_VERTEX];
+  uint8_t bone_weights[MAX_BONE_PER_VERTEX];
+};
+static_assert(sizeof(PackedAnimatedVertex) == 20, "PackedAnimatedVertex has unexpected padding");
+
+struct PackedVertices {
+  std::vector<PackedAnimatedVertex> vertices;
+  // A position is dequantized with position_offset + position_scale * (pos / 65535)
+  glm::vec3 position_scale{1.0f};
+  glm::vec3 position_offset{0.0f};
+};
+
+// The largest bone id that fits in a PackedAnimatedVertex
+static const int MAX_PACKED_BONE_ID = UINT8_MAX;
+
+/**
+ * Compresses the vertices of a mesh.
+ * @throws std::runtime_error if a bone id is larger than MAX_PACKED_BONE_ID.
+ */
+[[nodiscard]] PackedVertices pack_vertices(const std::vector<AnimatedVertex> &vertices);
+
+// The size of a single vertex in the given format
+[[nodiscard]] size_t get_vertex_size(VertexFormat format);
+
+// The largest number of vertices that a mesh may have for its indices to be stored as 16 bit
+static const size_t MAX_SHORT_INDEX_VERTEX_COUNT = UINT16_MAX;
+
+// The size of a single index on the GPU, 16 bit whenever every vertex of the mesh can be addressed with it
+[[nodiscard]] unsigned int get_index_size(size_t vertex_count);
+
+// GL_UNSIGNED_SHORT or GL_UNSIGNED_INT, for indices of the given size
+[[nodiscard]] unsigned int get_index_type(unsigned int index_size);
+
+#endif //OPENGL_SKELETAL_ANIMATION_SRC_RENDERER_VERTEXFORMAT_H_
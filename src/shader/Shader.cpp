@@ -1,3 +1,4 @@
+#include <algorithm>
 #include <glad/glad.h>
 #include <glm/glm.hpp>
 
@@ -23,7 +24,24 @@ Shader::Shader(const char *vertexPath, const char *fragmentPath) {
   loadShader(std::string(vertexPath), std::string(fragmentPath));
 }
 
+Shader::Shader(const char *vertexPath, const char *fragmentPath, std::vector<std::string> defines)
+	: m_defines(std::move(defines)) {
+  loadShader(std::string(vertexPath), std::string(fragmentPath));
+}
+
+/**
+ * @brief Creates a new compute shader object with the given shader file.
+ * @param computePath Path to the compute shader.
+ */
+Shader::Shader(const char *computePath) {
+  loadComputeShader(std::string(computePath));
+}
+
 void Shader::reload() {
+  if (!m_computePath.empty()) {
+	loadComputeShader(m_computePath);
+	return;
+  }
   loadShader(m_vertexPath, m_fragmentPath);
 }
 
@@ -47,6 +65,8 @@ void Shader::loadShader(const std::string &vertexPath, const std::string &fragme
 	throw std::runtime_error("Empty fragment shader");
   }
 
+  vertexCode = injectDefines(vertexCode, m_defines);
+  fragmentCode = injectDefines(fragmentCode, m_defines);
   const char *vCode = vertexCode.c_str();
   const char *fCode = fragmentCode.c_str();
   unsigned int vertexID, fragmentID;
@@ -61,6 +81,8 @@ void Shader::loadShader(const std::string &vertexPath, const std::string &fragme
   glCompileShader(fragmentID);
   checkCompileErrors(fragmentID, "FRAGMENT");
 
+  // The previous program is replaced when reloading
+  glDeleteProgram(shaderID);
   shaderID = glCreateProgram();
   glAttachShader(shaderID, vertexID);
   glAttachShader(shaderID, fragmentID);
@@ -70,6 +92,148 @@ void Shader::loadShader(const std::string &vertexPath, const std::string &fragme
 
   glDeleteShader(vertexID);
   glDeleteShader(fragmentID);
+
+  cacheUniformLocations();
+}
+
+void Shader::loadComputeShader(const std::string &computePath) {
+  m_computePath = computePath;
+  std::ifstream computeStream(computePath);
+
+  std::string computeCode((std::istreambuf_iterator<char>(computeStream)),
+						  (std::istreambuf_iterator<char>()));
+
+  if (computeCode.empty()) {
+	std::cerr << "Shader::loadComputeShader - empty compute shader\n";
+	throw std::runtime_error("Empty compute shader");
+  }
+
+  computeCode = injectDefines(computeCode, m_defines);
+  const char *cCode = computeCode.c_str();
+  unsigned int computeID = glCreateShader(GL_COMPUTE_SHADER);
+  glShaderSource(computeID, 1, &cCode, nullptr);
+  glCompileShader(computeID);
+  checkCompileErrors(computeID, "COMPUTE");
+
+  // The previous program is replaced when reloading
+  glDeleteProgram(shaderID);
+  shaderID = glCreateProgram();
+  glAttachShader(shaderID, computeID);
+
+  glLinkProgram(shaderID);
+  checkCompileErrors(shaderID, "PROGRAM");
+
+  glDeleteShader(computeID);
+
+  cacheUniformLocations();
+}
+
+std::string Shader::injectDefines(const std::string &code, const std::vector<std::string> &defines) {
+  if (defines.empty()) {
+	return code;
+  }
+
+  // Nothing but comments & whitespace may come before #version, so the defines go right after it
+  size_t insertAt = 0;
+  size_t version = code.find("#version");
+  if (version != std::string::npos) {
+	insertAt = code.find('\n', version);
+	insertAt = insertAt == std::string::npos ? code.size() : insertAt + 1;
+  }
+  int nextLine = 1 + (int)std::count(code.begin(), code.begin() + (long)insertAt, '\n');
+
+  std::string defineLines;
+  for (const auto &define : defines) {
+	defineLines += "#define " + define + "\n";
+  }
+  // Keeps the line numbers in compile errors the same as in the file
+  defineLines += "#line " + std::to_string(nextLine) + "\n";
+  return code.substr(0, insertAt) + defineLines + code.substr(insertAt);
+}
+
+void Shader::cacheUniformLocations() {
+  m_uniformLocations.clear();
+  m_blockBindings.clear();
+
+  GLint uniformCount = 0, maxNameLength = 0;
+  glGetProgramInterfaceiv(shaderID, GL_UNIFORM, GL_ACTIVE_RESOURCES, &uniformCount);
+  glGetProgramInterfaceiv(shaderID, GL_UNIFORM, GL_MAX_NAME_LENGTH, &maxNameLength);
+  std::string name;
+  for (GLint i = 0; i < uniformCount; i++) {
+	name.resize(maxNameLength);
+	GLsizei length = 0;
+	glGetProgramResourceName(shaderID, GL_UNIFORM, i, maxNameLength, &length, name.data());
+	name.resize(length);
+
+	// Members of uniform blocks have no location
+	GLint location = glGetProgramResourceLocation(shaderID, GL_UNIFORM, name.c_str());
+	if (location < 0) {
+	  continue;
+	}
+	m_uniformLocations[name] = location;
+	// Arrays are reported as "name[0]", but may also be set through their plain name
+	if (name.size() > 3 && name.compare(name.size() - 3, 3, "[0]") == 0) {
+	  m_uniformLocations[name.substr(0, name.size() - 3)] = location;
+	}
+  }
+
+  for (GLenum blockInterface : {GL_UNIFORM_BLOCK, GL_SHADER_STORAGE_BLOCK}) {
+	GLint blockCount = 0, maxBlockNameLength = 0;
+	glGetProgramInterfaceiv(shaderID, blockInterface, GL_ACTIVE_RESOURCES, &blockCount);
+	glGetProgramInterfaceiv(shaderID, blockInterface, GL_MAX_NAME_LENGTH, &maxBlockNameLength);
+	for (GLint i = 0; i < blockCount; i++) {
+	  name.resize(maxBlockNameLength);
+	  GLsizei length = 0;
+	  glGetProgramResourceName(shaderID, blockInterface, i, maxBlockNameLength, &length, name.data());
+	  name.resize(length);
+
+	  const GLenum property = GL_BUFFER_BINDING;
+	  GLint binding = 0;
+	  glGetProgramResourceiv(shaderID, blockInterface, i, 1, &property, 1, nullptr, &binding);
+	  m_blockBindings[name] = binding;
+	}
+  }
+
+  // Handles given out before a reload are resolved again by name
+  for (auto &slot : m_uniformSlots) {
+	slot.location = getUniformLocation(slot.name);
+  }
+}
+
+UniformHandle Shader::getUniformHandle(const std::string &name) {
+  for (unsigned int i = 0; i < m_uniformSlots.size(); i++) {
+	if (m_uniformSlots[i].name == name) {
+	  return UniformHandle{i};
+	}
+  }
+
+  m_uniformSlots.push_back({name, getUniformLocation(name)});
+  return UniformHandle{(unsigned int)m_uniformSlots.size() - 1};
+}
+
+GLint Shader::getUniformLocation(const std::string &name) const {
+  auto location = m_uniformLocations.find(name);
+  if (location != m_uniformLocations.end()) {
+	return location->second;
+  }
+
+  // Elements of arrays of basic types have consecutive locations, so "name[i]" is found through "name[0]"
+  auto bracket = name.find('[');
+  if (bracket != std::string::npos && name.back() == ']') {
+	auto base = m_uniformLocations.find(name.substr(0, bracket));
+	if (base != m_uniformLocations.end()) {
+	  return base->second + std::stoi(name.substr(bracket + 1));
+	}
+  }
+  return -1;
+}
+
+std::optional<GLint> Shader::getBlockBinding(const std::string &name) const {
+  auto binding = m_blockBindings.find(name);
+  if (binding == m_blockBindings.end()) {
+	return std::nullopt;
+  }
+  return binding->second;
 }
 
 /**
@@ -80,49 +244,85 @@ void Shader::use() const {
 }
 
 void Shader::setVec2(const std::string &name, const glm::vec2 &value) const {
-  glUniform2fv(glGetUniformLocation(shaderID, name.c_str()), 1, &value[0]);
+  glUniform2fv(getUniformLocation(name), 1, &value[0]);
 }
 
 void Shader::setVec2(const std::string &name, float x, float y) const {
-  glUniform2f(glGetUniformLocation(shaderID, name.c_str()), x, y);
+  glUniform2f(getUniformLocation(name), x, y);
 }
 
 void Shader::setVec3(const std::string &name, const glm::vec3 &value) const {
-  glUniform3fv(glGetUniformLocation(shaderID, name.c_str()), 1, &value[0]);
+  glUniform3fv(getUniformLocation(name), 1, &value[0]);
 }
 void Shader::setVec3(const std::string &name, float x, float y, float z) const {
-  glUniform3f(glGetUniformLocation(shaderID, name.c_str()), x, y, z);
+  glUniform3f(getUniformLocation(name), x, y, z);
 }
 
 void Shader::setVec4(const std::string &name, const glm::vec4 &value) const {
-  glUniform4fv(glGetUniformLocation(shaderID, name.c_str()), 1, &value[0]);
+  glUniform4fv(getUniformLocation(name), 1, &value[0]);
 }
 void Shader::setVec4(const std::string &name, float x, float y, float z, float w) {
-  glUniform4f(glGetUniformLocation(shaderID, name.c_str()), x, y, z, w);
+  glUniform4f(getUniformLocation(name), x, y, z, w);
 }
 
 void Shader::setMat2(const std::string &name, const glm::mat2 &mat) const {
-  glUniformMatrix2fv(glGetUniformLocation(shaderID, name.c_str()), 1, GL_FALSE, &mat[0][0]);
+  glUniformMatrix2fv(getUniformLocation(name), 1, GL_FALSE, &mat[0][0]);
 }
 
 void Shader::setMat3(const std::string &name, const glm::mat3 &mat) const {
-  glUniformMatrix3fv(glGetUniformLocation(shaderID, name.c_str()), 1, GL_FALSE, &mat[0][0]);
+  glUniformMatrix3fv(getUniformLocation(name), 1, GL_FALSE, &mat[0][0]);
 }
 
 void Shader::setMat4(const std::string &name, const glm::mat4 &mat) const {
-  glUniformMatrix4fv(glGetUniformLocation(shaderID, name.c_str()), 1, GL_FALSE, &mat[0][0]);
+  glUniformMatrix4fv(getUniformLocation(name), 1, GL_FALSE, &mat[0][0]);
 }
 
 void Shader::setBool(const std::string &name, bool value) const {
-  glUniform1i(glGetUniformLocation(shaderID, name.c_str()), (int)value);
+  glUniform1i(getUniformLocation(name), (int)value);
 }
 
 void Shader::setInt(const std::string &name, int value) const {
-  glUniform1i(glGetUniformLocation(shaderID, name.c_str()), value);
+  glUniform1i(getUniformLocation(name), value);
 }
 
 void Shader::setFloat(const std::string &name, float value) const {
-  glUniform1f(glGetUniformLocation(shaderID, name.c_str()), value);
+  glUniform1f(getUniformLocation(name), value);
+}
+
+void Shader::setBool(UniformHandle handle, bool value) const {
+  glUniform1i(m_uniformSlots[handle.index].location, (int)value);
+}
+
+void Shader::setInt(UniformHandle handle, int value) const {
+  glUniform1i(m_uniformSlots[handle.index].location, value);
+}
+
+void Shader::setFloat(UniformHandle handle, float value) const {
+  glUniform1f(m_uniformSlots[handle.index].location, value);
+}
+
+void Shader::setVec2(UniformHandle handle, const glm::vec2 &value) const {
+  glUniform2fv(m_uniformSlots[handle.index].location, 1, &value[0]);
+}
+
+void Shader::setVec3(UniformHandle handle, const glm::vec3 &value) const {
+  glUniform3fv(m_uniformSlots[handle.index].location, 1, &value[0]);
+}
+
+void Shader::setVec4(UniformHandle handle, const glm::vec4 &value) const {
+  glUniform4fv(m_uniformSlots[handle.index].location, 1, &value[0]);
+}
+
+void Shader::setMat2(UniformHandle handle, const glm::mat2 &mat) const {
+  glUniformMatrix2fv(m_uniformSlots[handle.index].location, 1, GL_FALSE, &mat[0][0]);
+}
+
+void Shader::setMat3(UniformHandle handle, const glm::mat3 &mat) const {
+  glUniformMatrix3fv(m_uniformSlots[handle.index].location, 1, GL_FALSE, &mat[0][0]);
+}
+
+void Shader::setMat4(UniformHandle handle, const glm::mat4 &mat) const {
+  glUniformMatrix4fv(m_uniformSlots[handle.index].location, 1, GL_FALSE, &mat[0][0]);
 }
 
 /**
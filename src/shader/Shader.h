@@ -8,6 +8,9 @@
 #include <fstream>
 #include <sstream>
 #include <iostream>
+#include <optional>
+#include <unordered_map>
+#include <vector>
 
 /**
  * Shader.cpp
@@ -21,6 +24,14 @@
  * in the Shader class.
  */
 
+/**
+ * @brief A pre-resolved uniform, which can be set without any string work or GL
+ * queries. Handles stay valid when the shader is reloaded.
+ */
+struct UniformHandle {
+  unsigned int index;
+};
+
 class Shader {
  public:
   unsigned int shaderID{};
@@ -41,6 +52,22 @@ class Shader {
   */
   Shader(const char *vertexPath, const char *fragmentPath);
 
+  /**
+   * @brief Creates a new shader object with the given shader files, compiled with extra preprocessor definitions.
+   * @param vertexPath Path to the vertex shader.
+   * @param fragmentPath Path to the fragment shader.
+   * @param defines Inserted as "#define <entry>" right after the #version line of both shaders, e.g. "NAME 2".
+   * @throws Runtime error if either the vertex shader or the fragment shader could not be found.
+  */
+  Shader(const char *vertexPath, const char *fragmentPath, std::vector<std::string> defines);
+
+  /**
+   * @brief Creates a new compute shader object with the given shader file.
+   * @param computePath Path to the compute shader.
+   * @throws Runtime error if the compute shader could not be found.
+  */
+  explicit Shader(const char *computePath);
+
   /**
    * @brief Sets the current shader as active.
   */
@@ -48,9 +75,31 @@ class Shader {
 
   // Loads a shader from the given path
   void loadShader(const std::string& vertexPath, const std::string& fragmentPath);
+  // Loads a compute shader from the given path
+  void loadComputeShader(const std::string& computePath);
   // Reloads the most recent shader path from disk.
   void reload();
 
+  /**
+   * @brief Returns a handle for the uniform with the given name, which is
+   * resolved again whenever the shader is reloaded.
+   * @note Uniforms that are not active in the shader are silently ignored when set,
+   * just like with glUniform.
+   */
+  [[nodiscard]] UniformHandle getUniformHandle(const std::string &name);
+
+  // Returns the location of an active uniform from the cache, or -1 if there is no such uniform
+  [[nodiscard]] GLint getUniformLocation(const std::string &name) const;
+
+  /**
+   * @brief Inserts a "#define <entry>" line for every entry after the #version line of the given source,
+   * followed by a #line directive so that compile errors keep the file's line numbers.
+   */
+  [[nodiscard]] static std::string injectDefines(const std::string &code, const std::vector<std::string> &defines);
+
+  // Returns the binding point of a uniform block or shader storage block
+  [[nodiscard]] std::optional<GLint> getBlockBinding(const std::string &name) const;
+
   void setBool(const std::string &name, bool value) const;
 
   void setInt(const std::string &name, int value) const;
@@ -71,6 +120,16 @@ class Shader {
 
   void setMat4(const std::string &name, const glm::mat4 &mat) const;
 
+  void setBool(UniformHandle handle, bool value) const;
+  void setInt(UniformHandle handle, int value) const;
+  void setFloat(UniformHandle handle, float value) const;
+  void setVec2(UniformHandle handle, const glm::vec2 &value) const;
+  void setVec3(UniformHandle handle, const glm::vec3 &value) const;
+  void setVec4(UniformHandle handle, const glm::vec4 &value) const;
+  void setMat2(UniformHandle handle, const glm::mat2 &mat) const;
+  void setMat3(UniformHandle handle, const glm::mat3 &mat) const;
+  void setMat4(UniformHandle handle, const glm::mat4 &mat) const;
+
   [[nodiscard]] std::string getVertexPath() const {
 	return m_vertexPath;
   }
@@ -79,8 +138,33 @@ class Shader {
 	return m_fragmentPath;
   }
 
+  [[nodiscard]] std::string getComputePath() const {
+	return m_computePath;
+  }
+
+  [[nodiscard]] const std::vector<std::string> &getDefines() const {
+	return m_defines;
+  }
+
  private:
-  std::string m_vertexPath, m_fragmentPath;
+  struct UniformSlot {
+	std::string name;
+	GLint location;
+  };
+
+  std::string m_vertexPath, m_fragmentPath, m_computePath;
+  std::vector<std::string> m_defines;
+  // Locations of every active uniform & bindings of every block, filled in after linking
+  std::unordered_map<std::string, GLint> m_uniformLocations;
+  std::unordered_map<std::string, GLint> m_blockBindings;
+  // Indexed by UniformHandle::index
+  std::vector<UniformSlot> m_uniformSlots;
+
+  /**
+   * @brief Introspects the linked program's active uniforms and blocks and
+   * re-resolves every handle that has been given out.
+   */
+  void cacheUniformLocations();
 
   /**
    * @brief Checks if there were any errors when compiling the shaders, if
@@ -0,0 +1,27 @@
+//
+// Created by tor on 10/19/26.
+//
+
+#include <algorithm>
+#include "ShaderPermutations.h"
+
+ShaderPermutations::ShaderPermutations(std::string vertexPath, std::string fragmentPath)
+	: m_vertexPath(std::move(vertexPath)), m_fragmentPath(std::move(fragmentPath)) {}
+
+Shader &ShaderPermutations::get(const std::vector<std::string> &defines) {
+  std::vector<std::string> key = defines;
+  std::sort(key.begin(), key.end());
+
+  auto permutation = m_permutations.find(key);
+  if (permutation == m_permutations.end()) {
+	auto shader = std::make_unique<Shader>(m_vertexPath.c_str(), m_fragmentPath.c_str(), key);
+	permutation = m_permutations.emplace(std::move(key), std::move(shader)).first;
+  }
+  return *permutation->second;
+}
+
+void ShaderPermutations::reload() {
+  for (auto &[defines, shader] : m_permutations) {
+	shader->reload();
+  }
+}
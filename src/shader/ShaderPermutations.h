@@ -0,0 +1,42 @@
+//
+// Created by tor on 10/19/26.
+//
+
+#ifndef OPENGL_SKELETAL_ANIMATION_SRC_SHADER_SHADERPERMUTATIONS_H_
+#define OPENGL_SKELETAL_ANIMATION_SRC_SHADER_SHADERPERMUTATIONS_H_
+
+#include <map>
+#include <memory>
+#include <string>
+#include <vector>
+#include "shader/Shader.h"
+
+/**
+ * A cache of the variants of one vertex & fragment shader pair, each compiled with a different set of
+ * preprocessor definitions (see Shader's defines). A variant is compiled the first time it is requested and is
+ * kept for as long as the cache lives, so requesting it again is only a lookup.
+ */
+class ShaderPermutations {
+ public:
+  ShaderPermutations(std::string vertexPath, std::string fragmentPath);
+
+  /**
+   * @brief Returns the variant compiled with the given defines, in any order.
+   * @throws Runtime error if the variant has to be compiled & either shader could not be found.
+   */
+  Shader &get(const std::vector<std::string> &defines);
+
+  // Reloads every variant that has been compiled so far from disk
+  void reload();
+
+  [[nodiscard]] size_t getPermutationCount() const {
+	return m_permutations.size();
+  }
+
+ private:
+  std::string m_vertexPath, m_fragmentPath;
+  // Keyed by the sorted defines, the shaders are not movable so they are kept behind pointers
+  std::map<std::vector<std::string>, std::unique_ptr<Shader>> m_permutations;
+};
+
+#endif //OPENGL_SKELETAL_ANIMATION_SRC_SHADER_SHADERPERMUTATIONS_H_